@@ -4,11 +4,30 @@
 #include <cstdint>
 #include <cstring>
 #include <array>
+#include <bit>
+#include <vector>
+#include <algorithm>
+#include <span>
 #include <string>
 #include <string_view>
 #include <ranges>
+#include <utility>
 #include <type_traits>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#include "tracelib.hpp"
+#include "probelib.hpp"
+
+extern "C" {
+    #include <sys/uio.h>
+}
+
 namespace ubn {
     namespace authlib::detail {
         enum CRCTypes {
@@ -18,6 +37,10 @@ namespace ubn {
             crc64_ecma, crc64_iso
         };
 
+        enum CRCKernels {
+            automatic, bytewise, slicing, hardware
+        };
+
         template <const std::size_t size, typename T, std::enable_if_t<std::is_integral_v<T>, bool> = true>
         constexpr T binaryReverse(T _byte) noexcept {
             auto reversed_byte { static_cast<T>(0x00) };
@@ -47,82 +70,263 @@ namespace ubn {
             return crc_table;
         }
 
-        template <
-            typename V, V polynomial, V init, V xor_out, bool ref_in, bool ref_out, std::enable_if_t<std::is_integral_v<V>, bool> = true
-        > auto generateCRCCode(const uint8_t* _data, std::size_t _size) noexcept {
-            constexpr std::size_t bits  { sizeof(V) * 8 };
+        template <typename V, std::enable_if_t<std::is_integral_v<V>, bool> = true>
+        struct CRCModel {
+            V    polynomial;
+            V    init;
+            V    xor_out;
+            bool ref_in;
+            bool ref_out;
+            V    check;
+        };
+
+        template <CRCTypes T>
+        constexpr auto getCRCModel() noexcept {
+            if constexpr (T == CRCTypes::crc8)          { return CRCModel<uint8_t> { 0x07, 0x00, 0x00, false, false, 0xf4 }; }
+            if constexpr (T == CRCTypes::crc8_cdma2000) { return CRCModel<uint8_t> { 0x9b, 0xff, 0x00, false, false, 0xda }; }
+            if constexpr (T == CRCTypes::crc8_darc)     { return CRCModel<uint8_t> { 0x39, 0x00, 0x00, true,  true,  0x15 }; }
+            if constexpr (T == CRCTypes::crc8_dvb_s2)   { return CRCModel<uint8_t> { 0xd5, 0x00, 0x00, false, false, 0xbc }; }
+            if constexpr (T == CRCTypes::crc8_ebu)      { return CRCModel<uint8_t> { 0x1d, 0xff, 0x00, true,  true,  0x97 }; }
+            if constexpr (T == CRCTypes::crc8_i_code)   { return CRCModel<uint8_t> { 0x1d, 0xfd, 0x00, false, false, 0x7e }; }
+            if constexpr (T == CRCTypes::crc8_itu)      { return CRCModel<uint8_t> { 0x07, 0x00, 0x55, false, false, 0xa1 }; }
+            if constexpr (T == CRCTypes::crc8_maxim)    { return CRCModel<uint8_t> { 0x31, 0x00, 0x00, true,  true,  0xa1 }; }
+            if constexpr (T == CRCTypes::crc8_rohc)     { return CRCModel<uint8_t> { 0x07, 0xff, 0x00, true,  true,  0xd0 }; }
+            if constexpr (T == CRCTypes::crc8_wcdma)    { return CRCModel<uint8_t> { 0x9b, 0x00, 0x00, true,  true,  0x25 }; }
+
+            if constexpr (T == CRCTypes::crc16_a)           { return CRCModel<uint16_t> { 0x1021, 0xc6c6, 0x0000, true,  true,  0xbf05 }; }
+            if constexpr (T == CRCTypes::crc16_arc)         { return CRCModel<uint16_t> { 0x8005, 0x0000, 0x0000, true,  true,  0xbb3d }; }
+            if constexpr (T == CRCTypes::crc16_aug_ccitt)   { return CRCModel<uint16_t> { 0x1021, 0x1d0f, 0x0000, false, false, 0xe5cc }; }
+            if constexpr (T == CRCTypes::crc16_buypass)     { return CRCModel<uint16_t> { 0x8005, 0x0000, 0x0000, false, false, 0xfee8 }; }
+            if constexpr (T == CRCTypes::crc16_cdma2000)    { return CRCModel<uint16_t> { 0xc867, 0xffff, 0x0000, false, false, 0x4c06 }; }
+            if constexpr (T == CRCTypes::crc16_ccitt_false) { return CRCModel<uint16_t> { 0x1021, 0xffff, 0x0000, false, false, 0x29b1 }; }
+            if constexpr (T == CRCTypes::crc16_dds_110)     { return CRCModel<uint16_t> { 0x8005, 0x800d, 0x0000, false, false, 0x9ecf }; }
+            if constexpr (T == CRCTypes::crc16_dect_r)      { return CRCModel<uint16_t> { 0x0589, 0x0000, 0x0001, false, false, 0x007e }; }
+            if constexpr (T == CRCTypes::crc16_dect_x)      { return CRCModel<uint16_t> { 0x0589, 0x0000, 0x0000, false, false, 0x007f }; }
+            if constexpr (T == CRCTypes::crc16_dnp)         { return CRCModel<uint16_t> { 0x3d65, 0x0000, 0xffff, true,  true,  0xea82 }; }
+            if constexpr (T == CRCTypes::crc16_en_13757)    { return CRCModel<uint16_t> { 0x3d65, 0x0000, 0xffff, false, false, 0xc2b7 }; }
+            if constexpr (T == CRCTypes::crc16_genibus)     { return CRCModel<uint16_t> { 0x1021, 0xffff, 0xffff, false, false, 0xd64e }; }
+            if constexpr (T == CRCTypes::crc16_kermit)      { return CRCModel<uint16_t> { 0x1021, 0x0000, 0x0000, true,  true,  0x2189 }; }
+            if constexpr (T == CRCTypes::crc16_maxim)       { return CRCModel<uint16_t> { 0x8005, 0x0000, 0xffff, true,  true,  0x44c2 }; }
+            if constexpr (T == CRCTypes::crc16_mcrf4xx)     { return CRCModel<uint16_t> { 0x1021, 0xffff, 0x0000, true,  true,  0x6f91 }; }
+            if constexpr (T == CRCTypes::crc16_modbus)      { return CRCModel<uint16_t> { 0x8005, 0xffff, 0x0000, true,  true,  0x4b37 }; }
+            if constexpr (T == CRCTypes::crc16_riello)      { return CRCModel<uint16_t> { 0x1021, 0xb2aa, 0x0000, true,  true,  0x63d0 }; }
+            if constexpr (T == CRCTypes::crc16_t10_dif)     { return CRCModel<uint16_t> { 0x8bb7, 0x0000, 0x0000, false, false, 0xd0db }; }
+            if constexpr (T == CRCTypes::crc16_teledisk)    { return CRCModel<uint16_t> { 0xa097, 0x0000, 0x0000, false, false, 0x0fb3 }; }
+            if constexpr (T == CRCTypes::crc16_tms37157)    { return CRCModel<uint16_t> { 0x1021, 0x89ec, 0x0000, true,  true,  0x26b1 }; }
+            if constexpr (T == CRCTypes::crc16_usb)         { return CRCModel<uint16_t> { 0x8005, 0xffff, 0xffff, true,  true,  0xb4c8 }; }
+            if constexpr (T == CRCTypes::crc16_x_25)        { return CRCModel<uint16_t> { 0x1021, 0xffff, 0xffff, true,  true,  0x906e }; }
+            if constexpr (T == CRCTypes::crc16_xmodem)      { return CRCModel<uint16_t> { 0x1021, 0x0000, 0x0000, false, false, 0x31c3 }; }
+
+            if constexpr (T == CRCTypes::crc32)        { return CRCModel<uint32_t> { 0x04c11db7, 0xffffffff, 0xffffffff, true,  true,  0xcbf43926 }; }
+            if constexpr (T == CRCTypes::crc32_bzip2)  { return CRCModel<uint32_t> { 0x04c11db7, 0xffffffff, 0xffffffff, false, false, 0xfc891918 }; }
+            if constexpr (T == CRCTypes::crc32_c)      { return CRCModel<uint32_t> { 0x1edc6f41, 0xffffffff, 0xffffffff, true,  true,  0xe3069283 }; }
+            if constexpr (T == CRCTypes::crc32_d)      { return CRCModel<uint32_t> { 0xa833982b, 0xffffffff, 0xffffffff, true,  true,  0x87315576 }; }
+            if constexpr (T == CRCTypes::crc32_jamcrc) { return CRCModel<uint32_t> { 0x04c11db7, 0xffffffff, 0x00000000, true,  true,  0x340bc6d9 }; }
+            if constexpr (T == CRCTypes::crc32_mpeg_2) { return CRCModel<uint32_t> { 0x04c11db7, 0xffffffff, 0x00000000, false, false, 0x0376e6e7 }; }
+            if constexpr (T == CRCTypes::crc32_posix)  { return CRCModel<uint32_t> { 0x04c11db7, 0x00000000, 0xffffffff, false, false, 0x765e7680 }; }
+            if constexpr (T == CRCTypes::crc32_q)      { return CRCModel<uint32_t> { 0x814141ab, 0x00000000, 0x00000000, false, false, 0x3010bf7f }; }
+            if constexpr (T == CRCTypes::crc32_xfer)   { return CRCModel<uint32_t> { 0x000000af, 0x00000000, 0x00000000, false, false, 0xbd0be338 }; }
+
+            if constexpr (T == CRCTypes::crc64_ecma) { return CRCModel<uint64_t> { 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, true, true, 0x995dc9bbdf1939fa }; }
+            if constexpr (T == CRCTypes::crc64_iso)  { return CRCModel<uint64_t> { 0x000000000000001b, 0xffffffffffffffff, 0xffffffffffffffff, true, true, 0xb90956c775a41001 }; }
+        }
+
+        template <CRCTypes T>
+        using CRCValue = decltype(getCRCModel<T>().polynomial);
+
+        template <CRCTypes T>
+        inline constexpr auto crc_model { getCRCModel<T>() };
+
+        // Catalogue init is unreflected, reflected CRC starts with the reflected register
+        template <CRCTypes T>
+        inline constexpr auto crc_init { crc_model<T>.ref_in ? binaryReverse<sizeof(CRCValue<T>) * 8>(crc_model<T>.init) : crc_model<T>.init };
+
+        template <CRCTypes T>
+        inline constexpr auto crc_table { generateCRCTable<CRCValue<T>>(crc_model<T>.polynomial, crc_model<T>.ref_in, crc_model<T>.ref_out) };
+
+        template <CRCTypes T>
+        constexpr auto updateCRCCode(CRCValue<T> _crc_code, const uint8_t* _data, std::size_t _size) noexcept {
+            constexpr std::size_t bits  { sizeof(CRCValue<T>) * 8 };
             constexpr std::size_t shift { bits - 8 };
+            constexpr auto        model { crc_model<T> };
+
+            for (; _size != 0; --_size) {
+                _crc_code = (model.ref_out ? _crc_code >> 8 : _crc_code << 8) ^ crc_table<T>[(model.ref_in ? _crc_code & 0xff : _crc_code >> shift) ^ *_data++];
+            }
+
+            return _crc_code;
+        }
+
+        template <CRCTypes T>
+        constexpr auto updateCRCBits(CRCValue<T> _crc_code, uint64_t _value, std::size_t _bits) noexcept {
+            constexpr std::size_t bits  { sizeof(CRCValue<T>) * 8 };
+            constexpr std::size_t shift { bits - 8 };
+            constexpr auto        model { crc_model<T> };
+
+            // Whole bytes through the table, reflected CRC consumes bits from the lowest one
+            for (; _bits >= 8; _bits -= 8) {
+                const auto byte { static_cast<uint8_t>(model.ref_in ? _value : _value >> (_bits - 8)) };
+                _crc_code = updateCRCCode<T>(_crc_code, &byte, 1);
+                if constexpr (model.ref_in) { _value >>= 8; }
+            }
+            if (_bits == 0) { return _crc_code; }
+
+            // Remaining bits index the table with zero padding, the padded steps are plain shifts
+            const auto mask { static_cast<uint8_t>((0x01 << _bits) - 1) };
+            if constexpr (model.ref_in) {
+                const auto index { static_cast<uint8_t>(((_crc_code ^ _value) & mask) << (8 - _bits)) };
+                return static_cast<CRCValue<T>>((_crc_code >> _bits) ^ crc_table<T>[index]);
+            } else {
+                const auto index { static_cast<uint8_t>(((_crc_code >> (shift + 8 - _bits)) ^ _value) & mask) };
+                return static_cast<CRCValue<T>>(static_cast<CRCValue<T>>(_crc_code << _bits) ^ crc_table<T>[index]);
+            }
+        }
+
+        inline uint64_t loadU64LE(const uint8_t* _data) noexcept {
+            uint64_t value { 0 };
+            for (std::size_t i = 0; i != 8; ++i) { value |= static_cast<uint64_t>(_data[i]) << (i * 8); }
+            return value;
+        }
+
+        inline uint64_t loadU64BE(const uint8_t* _data) noexcept {
+            uint64_t value { 0 };
+            for (std::size_t i = 0; i != 8; ++i) { value = value << 8 | _data[i]; }
+            return value;
+        }
+
+        template <CRCTypes T>
+        constexpr auto generateCRCSlicingTable() noexcept {
+            constexpr std::size_t bits  { sizeof(CRCValue<T>) * 8 };
+            constexpr std::size_t shift { bits - 8 };
+            constexpr auto        model { crc_model<T> };
+
+            // Table k is a byte followed by k zero bytes
+            std::array<std::array<CRCValue<T>, 256>, 8> slicing_table;
+            slicing_table[0] = crc_table<T>;
+            for (std::size_t k = 1; k != slicing_table.size(); ++k) {
+                for (std::size_t byte = 0; byte != 256; ++byte) {
+                    const auto crc { slicing_table[k - 1][byte] };
+                    slicing_table[k][byte] = static_cast<CRCValue<T>>(
+                        (model.ref_out ? crc >> 8 : crc << 8) ^ crc_table<T>[model.ref_in ? crc & 0xff : crc >> shift]
+                    );
+                }
+            }
+
+            return slicing_table;
+        }
+
+        template <CRCTypes T>
+        inline constexpr auto crc_slicing_table { generateCRCSlicingTable<T>() };
+
+        template <CRCTypes T>
+        CRCValue<T> updateCRCCodeSlicing(CRCValue<T> _crc_code, const uint8_t* _data, std::size_t _size) noexcept {
+            constexpr std::size_t bits  { sizeof(CRCValue<T>) * 8 };
+            constexpr auto        model { crc_model<T> };
+
+            // Slicing-by-8, the whole register is shifted out by 8 bytes for CRC up to 64 bits
+            for (; _size >= 8; _size -= 8, _data += 8) {
+                const uint64_t word {
+                    model.ref_in ? loadU64LE(_data) ^ static_cast<uint64_t>(_crc_code) : loadU64BE(_data) ^ static_cast<uint64_t>(_crc_code) << (64 - bits)
+                };
+                CRCValue<T> crc_code { 0 };
+                for (std::size_t i = 0; i != 8; ++i) {
+                    crc_code ^= crc_slicing_table<T>[7 - i][(model.ref_in ? word >> (i * 8) : word >> (56 - i * 8)) & 0xff];
+                }
+                _crc_code = crc_code;
+            }
+
+            return updateCRCCode<T>(_crc_code, _data, _size);
+        }
+
+#if defined(__x86_64__)
+        __attribute__((target("sse4.2")))
+        inline uint32_t updateCRC32CSSE42(const uint32_t _crc_code, const uint8_t* _data, std::size_t _size) noexcept {
+            uint64_t crc_code { _crc_code };
+            for (; _size >= 8; _size -= 8, _data += 8) { crc_code = _mm_crc32_u64(crc_code, loadU64LE(_data)); }
+            for (; _size != 0; --_size) { crc_code = _mm_crc32_u8(static_cast<uint32_t>(crc_code), *_data++); }
+            return static_cast<uint32_t>(crc_code);
+        }
+
+        inline bool hasSSE42() noexcept {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.2");
+        }
+
+        inline const bool crc32c_hardware { hasSSE42() };
+#elif defined(__ARM_FEATURE_CRC32)
+        inline uint32_t updateCRC32ARM(uint32_t _crc_code, const uint8_t* _data, std::size_t _size) noexcept {
+            for (; _size >= 8; _size -= 8, _data += 8) { _crc_code = __crc32d(_crc_code, loadU64LE(_data)); }
+            for (; _size != 0; --_size) { _crc_code = __crc32b(_crc_code, *_data++); }
+            return _crc_code;
+        }
+
+        inline uint32_t updateCRC32CARM(uint32_t _crc_code, const uint8_t* _data, std::size_t _size) noexcept {
+            for (; _size >= 8; _size -= 8, _data += 8) { _crc_code = __crc32cd(_crc_code, loadU64LE(_data)); }
+            for (; _size != 0; --_size) { _crc_code = __crc32cb(_crc_code, *_data++); }
+            return _crc_code;
+        }
+#endif
 
-            static constexpr auto crc_table { generateCRCTable<V>(polynomial, ref_in, ref_out) };
-            auto                  crc_code  { init };
-            do {
-                crc_code = (ref_out ? crc_code >> 8 : crc_code << 8) ^ crc_table.at((ref_in ? crc_code & 0xff : crc_code >> shift) ^ *_data++);
-            } while (--_size);
+        template <CRCTypes T>
+        bool hasCRCHardware() noexcept {
+#if defined(__x86_64__)
+            if constexpr (T == CRCTypes::crc32_c) { return crc32c_hardware; }
+#elif defined(__ARM_FEATURE_CRC32)
+            if constexpr (T == CRCTypes::crc32 || T == CRCTypes::crc32_jamcrc || T == CRCTypes::crc32_c) { return true; }
+#endif
+            return false;
+        }
+
+        template <CRCTypes T>
+        CRCValue<T> updateCRCCodeHardware(const CRCValue<T> _crc_code, const uint8_t* _data, const std::size_t _size) noexcept {
+#if defined(__x86_64__)
+            if constexpr (T == CRCTypes::crc32_c) {
+                if (crc32c_hardware) { return updateCRC32CSSE42(_crc_code, _data, _size); }
+            }
+#elif defined(__ARM_FEATURE_CRC32)
+            if constexpr (T == CRCTypes::crc32 || T == CRCTypes::crc32_jamcrc) { return updateCRC32ARM(_crc_code, _data, _size); }
+            if constexpr (T == CRCTypes::crc32_c)                              { return updateCRC32CARM(_crc_code, _data, _size); }
+#endif
+            return updateCRCCodeSlicing<T>(_crc_code, _data, _size);
+        }
 
-            return crc_code ^ xor_out;
+        template <CRCTypes T, CRCKernels K = CRCKernels::automatic>
+        CRCValue<T> updateCRCCodeKernel(const CRCValue<T> _crc_code, const uint8_t* _data, const std::size_t _size) noexcept {
+            if constexpr (K == CRCKernels::bytewise) { return updateCRCCode<T>(_crc_code, _data, _size); }
+            if constexpr (K == CRCKernels::slicing)  { return updateCRCCodeSlicing<T>(_crc_code, _data, _size); }
+            if constexpr (K == CRCKernels::hardware) { return updateCRCCodeHardware<T>(_crc_code, _data, _size); }
+            if constexpr (K == CRCKernels::automatic) {
+                if (hasCRCHardware<T>()) { return updateCRCCodeHardware<T>(_crc_code, _data, _size); }
+                if (_size >= 16)         { return updateCRCCodeSlicing<T>(_crc_code, _data, _size); }
+                return updateCRCCode<T>(_crc_code, _data, _size);
+            }
         }
+
+        template <CRCTypes T, CRCKernels K = CRCKernels::automatic>
+        auto generateCRCCode(const uint8_t* _data, const std::size_t _size) noexcept {
+            return static_cast<CRCValue<T>>(updateCRCCodeKernel<T, K>(crc_init<T>, _data, _size) ^ crc_model<T>.xor_out);
+        }
+
+        template <typename V>
+        concept ByteRange = std::ranges::contiguous_range<V> && sizeof(std::ranges::range_value_t<V>) == 1;
+
+        template <typename V>
+        concept SegmentRange = std::ranges::input_range<V> && ByteRange<std::ranges::range_value_t<V>>;
     }
 
-    using crc_types = authlib::detail::CRCTypes;
+    using crc_types   = authlib::detail::CRCTypes;
+    using crc_kernels = authlib::detail::CRCKernels;
 
-    template <crc_types T, std::enable_if_t<std::is_same_v<decltype(T), crc_types>, bool> = true>
+    template <crc_types T, crc_kernels K = crc_kernels::automatic, std::enable_if_t<std::is_same_v<decltype(T), crc_types>, bool> = true>
     constexpr auto crc_gen(const uint8_t* _data, const std::size_t _size) noexcept {
-        using namespace ubn::authlib::detail;
+        return authlib::detail::generateCRCCode<T, K>(_data, _size);
+    }
 
-        if constexpr (T == crc_types::crc8)          { return generateCRCCode<uint8_t, 0x07, 0x00, 0x00, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc8_cdma2000) { return generateCRCCode<uint8_t, 0x9b, 0xff, 0x00, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc8_darc)     { return generateCRCCode<uint8_t, 0x39, 0x00, 0x00, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc8_dvb_s2)   { return generateCRCCode<uint8_t, 0xd5, 0x00, 0x00, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc8_ebu)      { return generateCRCCode<uint8_t, 0x1d, 0xff, 0x00, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc8_i_code)   { return generateCRCCode<uint8_t, 0x1d, 0xfd, 0x00, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc8_itu)      { return generateCRCCode<uint8_t, 0x07, 0x00, 0x55, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc8_maxim)    { return generateCRCCode<uint8_t, 0x31, 0x00, 0x00, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc8_rohc)     { return generateCRCCode<uint8_t, 0x07, 0xff, 0x00, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc8_wcdma)    { return generateCRCCode<uint8_t, 0x9b, 0x00, 0x00, true,  true >(_data, _size); }
-
-        if constexpr (T == crc_types::crc16_a)           { return generateCRCCode<uint16_t, 0x1021, 0xc6c6, 0x0000, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_arc)         { return generateCRCCode<uint16_t, 0x8005, 0x0000, 0x0000, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_aug_ccitt)   { return generateCRCCode<uint16_t, 0x1021, 0x1d0f, 0x0000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_buypass)     { return generateCRCCode<uint16_t, 0x8005, 0x0000, 0x0000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_cdma2000)    { return generateCRCCode<uint16_t, 0xc867, 0xffff, 0x0000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_ccitt_false) { return generateCRCCode<uint16_t, 0x1021, 0xffff, 0x0000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_dds_110)     { return generateCRCCode<uint16_t, 0x8005, 0x800d, 0x0000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_dect_r)      { return generateCRCCode<uint16_t, 0x0589, 0x0000, 0x0001, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_dect_x)      { return generateCRCCode<uint16_t, 0x0589, 0x0000, 0x0000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_dnp)         { return generateCRCCode<uint16_t, 0x3d65, 0x0000, 0xffff, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_en_13757)    { return generateCRCCode<uint16_t, 0x3d65, 0x0000, 0xffff, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_genibus)     { return generateCRCCode<uint16_t, 0x1021, 0xffff, 0xffff, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_kermit)      { return generateCRCCode<uint16_t, 0x1021, 0x0000, 0x0000, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_maxim)       { return generateCRCCode<uint16_t, 0x8005, 0x0000, 0xffff, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_mcrf4xx)     { return generateCRCCode<uint16_t, 0x1021, 0xffff, 0x0000, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_modbus)      { return generateCRCCode<uint16_t, 0x8005, 0xffff, 0x0000, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_riello)      { return generateCRCCode<uint16_t, 0x1021, 0xb2aa, 0x0000, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_t10_dif)     { return generateCRCCode<uint16_t, 0x8bb7, 0x0000, 0x0000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_teledisk)    { return generateCRCCode<uint16_t, 0xa097, 0x0000, 0x0000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc16_tms37157)    { return generateCRCCode<uint16_t, 0x1021, 0x89ec, 0x0000, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_usb)         { return generateCRCCode<uint16_t, 0x8005, 0xffff, 0xffff, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_x_25)        { return generateCRCCode<uint16_t, 0x1021, 0xffff, 0xffff, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc16_xmodem)      { return generateCRCCode<uint16_t, 0x1021, 0x0000, 0x0000, false, false>(_data, _size); }
-
-        if constexpr (T == crc_types::crc32)        { return generateCRCCode<uint32_t, 0x04c11db7, 0xffffffff, 0xffffffff, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc32_bzip2)  { return generateCRCCode<uint32_t, 0x04c11db7, 0xffffffff, 0xffffffff, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc32_c)      { return generateCRCCode<uint32_t, 0x1edc6f41, 0xffffffff, 0xffffffff, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc32_d)      { return generateCRCCode<uint32_t, 0xa833982b, 0xffffffff, 0xffffffff, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc32_jamcrc) { return generateCRCCode<uint32_t, 0x04c11db7, 0xffffffff, 0x00000000, true,  true >(_data, _size); }
-        if constexpr (T == crc_types::crc32_mpeg_2) { return generateCRCCode<uint32_t, 0x04c11db7, 0xffffffff, 0x00000000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc32_posix)  { return generateCRCCode<uint32_t, 0x04c11db7, 0x00000000, 0xffffffff, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc32_q)      { return generateCRCCode<uint32_t, 0x814141ab, 0x00000000, 0x00000000, false, false>(_data, _size); }
-        if constexpr (T == crc_types::crc32_xfer)   { return generateCRCCode<uint32_t, 0x000000af, 0x00000000, 0x00000000, false, false>(_data, _size); }
-
-        if constexpr (T == crc_types::crc64_ecma) { return generateCRCCode<uint64_t, 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, true, true>(_data, _size); }
-        if constexpr (T == crc_types::crc64_iso)  { return generateCRCCode<uint64_t, 0x000000000000001b, 0xffffffffffffffff, 0xffffffffffffffff, true, true>(_data, _size); }
-    }
-
-    template <crc_types T, typename V, std::enable_if_t<std::is_same_v<decltype(T), crc_types>, bool> = true>
+    template <crc_types T, typename V, std::enable_if_t<std::is_same_v<decltype(T), crc_types> && authlib::detail::ByteRange<V>, bool> = true>
     constexpr auto crc_gen(const V& _str) noexcept {
         return crc_gen<T>(
-            reinterpret_cast<const uint8_t*>(_str.data()),
-            _str.size()
+            reinterpret_cast<const uint8_t*>(std::ranges::data(_str)),
+            std::ranges::size(_str)
         );
     }
 
@@ -133,4 +337,1148 @@ namespace ubn {
             std::strlen(_str)
         );
     }
+
+    /*
+        @brief: Streaming CRC state, feed data segment by segment and read the checksum at any time
+    */
+    template <crc_types T>
+    class crc_state {
+    public:
+        using value_type = authlib::detail::CRCValue<T>;
+
+        /*
+            @brief: Default constructor of crc_state with the initial CRC register
+        */
+        constexpr crc_state() noexcept = default;
+
+        /*
+            @brief: Feed data to the CRC register
+            @param:  _data       - const uint8_t *, data to feed
+            @param:  _size       - const std::size_t, size of data
+            @return: crc_state & - this state
+        */
+        crc_state& update(const uint8_t* _data, const std::size_t _size) noexcept {
+            m_crc_code = authlib::detail::updateCRCCodeKernel<T>(m_crc_code, _data, _size);
+            return *this;
+        }
+
+        /*
+            @brief: Feed a contiguous range of byte sized elements to the CRC register
+            @param:  _str        - const V &, std::string_view, std::span<const std::byte>, etc.
+            @return: crc_state & - this state
+        */
+        template <typename V, std::enable_if_t<authlib::detail::ByteRange<V>, bool> = true>
+        crc_state& update(const V& _str) noexcept {
+            return update(reinterpret_cast<const uint8_t*>(std::ranges::data(_str)), std::ranges::size(_str));
+        }
+
+        /*
+            @brief: Feed a bit sequence not necessarily a multiple of 8 bits long to the CRC register
+            @param:  _value      - const uint64_t, bits to feed in its lowest _bits bits, fed from the highest one or from the lowest one for reflected CRC
+            @param:  _bits       - const std::size_t, number of bits, at most 64
+            @return: crc_state & - this state, update_bits(byte, 8) equals update(&byte, 1)
+        */
+        crc_state& update_bits(const uint64_t _value, const std::size_t _bits) noexcept {
+            m_crc_code = authlib::detail::updateCRCBits<T>(m_crc_code, _value, _bits);
+            return *this;
+        }
+
+        /*
+            @brief: Get CRC checksum of all data fed so far, the state is not modified
+            @return: value_type - CRC checksum
+        */
+        constexpr value_type value() const noexcept {
+            return static_cast<value_type>(m_crc_code ^ authlib::detail::crc_model<T>.xor_out);
+        }
+
+        /*
+            @brief: Reset to the initial CRC register
+        */
+        constexpr void reset() noexcept { m_crc_code = authlib::detail::crc_init<T>; }
+
+    private:
+        value_type m_crc_code { authlib::detail::crc_init<T> };
+    };
+
+    /*
+        @brief: Generate CRC checksum over non-contiguous segments without copying
+        @param:  _segments - const V &, range of contiguous byte ranges, e.g. the two halves of a wrapped ring buffer
+        @return: auto      - CRC checksum, same as crc_gen over the concatenated segments
+    */
+    template <crc_types T, typename V, std::enable_if_t<std::is_same_v<decltype(T), crc_types> && authlib::detail::SegmentRange<V>, bool> = true>
+    auto crc_gen(const V& _segments) noexcept {
+        crc_state<T> state;
+        for (const auto& segment : _segments) { state.update(segment); }
+        return state.value();
+    }
+
+    /*
+        @brief: Generate CRC checksum over an iovec chain without copying
+        @param:  _iov - std::span<const struct iovec>, iovec chain as used by readv/writev
+        @return: auto - CRC checksum, same as crc_gen over the concatenated buffers
+    */
+    template <crc_types T, std::enable_if_t<std::is_same_v<decltype(T), crc_types>, bool> = true>
+    auto crc_gen(const std::span<const struct iovec> _iov) noexcept {
+        crc_state<T> state;
+        for (const auto& iov : _iov) { state.update(static_cast<const uint8_t*>(iov.iov_base), iov.iov_len); }
+        return state.value();
+    }
+
+    namespace authlib::detail {
+        constexpr std::size_t crc_types_size { CRCTypes::crc64_iso + 1 };
+
+        using CRCFunction = uint64_t (*)(const uint8_t*, std::size_t) noexcept;
+
+        template <CRCTypes T>
+        uint64_t generateCRCCodeU64(const uint8_t* _data, const std::size_t _size) noexcept {
+            return static_cast<uint64_t>(crc_gen<T>(_data, _size));
+        }
+
+        template <std::size_t... I>
+        constexpr auto generateCRCFunctionTable(std::index_sequence<I...>) noexcept {
+            return std::array<CRCFunction, sizeof...(I)> { &generateCRCCodeU64<static_cast<CRCTypes>(I)>... };
+        }
+
+        inline constexpr auto crc_function_table { generateCRCFunctionTable(std::make_index_sequence<crc_types_size>{}) };
+    }
+
+    /*
+        @brief: Generate CRC checksum with crc_types selected at runtime
+        @param:  _type    - const crc_types, CRC checksum type
+        @param:  _data    - std::span<const uint8_t>, data to checksum
+        @return: uint64_t - CRC checksum zero-extended to 64 bits, 0 if _type is out of range
+    */
+    inline uint64_t crc_gen(const crc_types _type, const std::span<const uint8_t> _data) noexcept {
+        using namespace ubn::authlib::detail;
+
+        if (static_cast<std::size_t>(_type) >= crc_types_size) { return 0; }
+        return crc_function_table[_type](_data.data(), _data.size());
+    }
+
+    /*
+        @brief: Generate CRC checksum with crc_types selected at runtime
+        @param:  _type    - const crc_types, CRC checksum type
+        @param:  _str     - std::string_view, string to checksum
+        @return: uint64_t - CRC checksum zero-extended to 64 bits, 0 if _type is out of range
+    */
+    inline uint64_t crc_gen(const crc_types _type, const std::string_view _str) noexcept {
+        return crc_gen(_type, std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(_str.data()), _str.size()));
+    }
+
+    /*
+        @brief: Get catalogue check value, the CRC checksum of "123456789"
+        @return: auto - check value
+    */
+    template <crc_types T, std::enable_if_t<std::is_same_v<decltype(T), crc_types>, bool> = true>
+    constexpr auto crc_check() noexcept { return authlib::detail::crc_model<T>.check; }
+
+    /*
+        @brief: Whether a CRC kernel runs natively for crc_types on this CPU, unavailable hardware kernel falls back to slicing
+        @param:  _kernel - const crc_kernels, CRC kernel
+        @return: bool    - whether the kernel is available
+    */
+    template <crc_types T, std::enable_if_t<std::is_same_v<decltype(T), crc_types>, bool> = true>
+    bool crc_kernel_available(const crc_kernels _kernel) noexcept {
+        return _kernel != crc_kernels::hardware || authlib::detail::hasCRCHardware<T>();
+    }
+
+    namespace authlib::detail {
+        template <CRCTypes T>
+        bool verifyCRCCode() noexcept {
+            constexpr std::string_view check { "123456789" };
+            const auto* data { reinterpret_cast<const uint8_t*>(check.data()) };
+
+            bool verified {
+                generateCRCCode<T, CRCKernels::automatic>(data, check.size()) == crc_model<T>.check &&
+                generateCRCCode<T, CRCKernels::bytewise>(data, check.size())  == crc_model<T>.check &&
+                generateCRCCode<T, CRCKernels::slicing>(data, check.size())   == crc_model<T>.check
+            };
+            if (hasCRCHardware<T>()) { verified = verified && generateCRCCode<T, CRCKernels::hardware>(data, check.size()) == crc_model<T>.check; }
+
+            return verified;
+        }
+
+        template <std::size_t... I>
+        bool verifyCRCCodes(std::index_sequence<I...>) noexcept {
+            return (verifyCRCCode<static_cast<CRCTypes>(I)>() && ...);
+        }
+    }
+
+    /*
+        @brief: Self test all crc_types with every available kernel against catalogue check values
+        @return: bool - whether all checksums match
+    */
+    inline bool crc_verify() noexcept {
+        return authlib::detail::verifyCRCCodes(std::make_index_sequence<authlib::detail::crc_types_size>{});
+    }
+
+    namespace authlib::detail {
+        template <typename V>
+        struct CRCSyndrome {
+            V        syndrome;
+            uint32_t position;
+        };
+    }
+
+    /*
+        @brief: Syndrome table for single bit error correction, maps CRC mismatch to the flipped bit position
+    */
+    template <crc_types T>
+    class crc_syndrome_table {
+    public:
+        using value_type = authlib::detail::CRCValue<T>;
+
+        /*
+            @brief: Build syndrome table for frames up to _max_size bytes, positions sharing the same syndrome are dropped as uncorrectable
+            @param:  _max_size - const std::size_t, maximum frame data size in bytes
+        */
+        explicit crc_syndrome_table(const std::size_t _max_size) noexcept : m_max_size(_max_size) {
+            using namespace ubn::authlib::detail;
+
+            // CRC is linear, a flipped bit yields syndrome crc(e) with zero init and xor_out, which only depends on its distance to the frame end
+            constexpr uint8_t zero { 0x00 };
+            m_syndromes.reserve(_max_size * 8);
+            for (uint32_t bit = 0; bit != 8; ++bit) {
+                const uint8_t error    { static_cast<uint8_t>(0x01 << bit) };
+                auto          syndrome { updateCRCCode<T>(0, &error, 1) };
+                for (std::size_t distance = 0; distance != _max_size; ++distance) {
+                    m_syndromes.push_back({ syndrome, static_cast<uint32_t>(distance * 8 + bit) });
+                    syndrome = updateCRCCode<T>(syndrome, &zero, 1);
+                }
+            }
+            std::ranges::sort(m_syndromes, {}, &CRCSyndrome<value_type>::syndrome);
+
+            // Drop ambiguous syndromes, single bit syndromes stand for errors in the CRC code itself unless a data bit shares them
+            std::size_t kept { 0 };
+            for (std::size_t i = 0; i != m_syndromes.size(); ++i) {
+                const auto syndrome { m_syndromes[i].syndrome };
+                const bool ambiguous {
+                    (i != 0 && m_syndromes[i - 1].syndrome == syndrome) ||
+                    (i + 1 != m_syndromes.size() && m_syndromes[i + 1].syndrome == syndrome)
+                };
+                if (std::has_single_bit(syndrome)) { m_ambiguous |= syndrome; }
+                else if (!ambiguous)               { m_syndromes[kept++] = m_syndromes[i]; }
+            }
+            m_syndromes.resize(kept);
+            m_syndromes.shrink_to_fit();
+        }
+
+        /*
+            @brief: Check data against received CRC code and repair a single flipped bit in place
+            @param:  data_     - std::span<uint8_t>, received data, at most max_size() bytes
+            @param:  _crc_code - const value_type, received CRC code
+            @return: bool      - whether data is intact or has been repaired, false for corrupted data longer than max_size()
+        */
+        bool correct(const std::span<uint8_t> data_, const value_type _crc_code) const noexcept {
+            const auto syndrome { static_cast<value_type>(crc_gen<T>(data_.data(), data_.size()) ^ _crc_code) };
+            if (syndrome == 0) { return true; }
+            // Syndromes of bits beyond the table alias entries inside it, repairing would flip the wrong bit
+            if (data_.size() > m_max_size) { return false; }
+            if (std::has_single_bit(syndrome)) { return (syndrome & m_ambiguous) == 0; }
+
+            const auto position { locate(syndrome) };
+            if (position / 8 >= data_.size()) { return false; }
+            data_[data_.size() - 1 - position / 8] ^= static_cast<uint8_t>(0x01 << position % 8);
+
+            return true;
+        }
+
+        /*
+            @brief: Look up flipped bit position for a syndrome
+            @param:  _syndrome   - const value_type, received CRC code xor computed CRC code
+            @return: std::size_t - bit position counted from the end of the frame as byte distance * 8 + bit, SIZE_MAX if not found
+        */
+        std::size_t locate(const value_type _syndrome) const noexcept {
+            using namespace ubn::authlib::detail;
+
+            const auto it { std::ranges::lower_bound(m_syndromes, _syndrome, {}, &CRCSyndrome<value_type>::syndrome) };
+            if (it == m_syndromes.end() || it->syndrome != _syndrome) { return SIZE_MAX; }
+
+            return it->position;
+        }
+
+        /*
+            @brief: Get maximum frame data size covered by the table
+            @return: std::size_t - size in bytes
+        */
+        constexpr std::size_t max_size() const noexcept { return m_max_size; }
+
+    private:
+        std::size_t                                           m_max_size;
+        value_type                                            m_ambiguous { 0 };
+        std::vector<authlib::detail::CRCSyndrome<value_type>> m_syndromes;
+    };
+
+    /*
+        @brief: Rolling CRC over a fixed size window, slides by one byte in O(1)
+    */
+    template <crc_types T>
+    class crc_rolling {
+    public:
+        using value_type = authlib::detail::CRCValue<T>;
+
+        /*
+            @brief: Init rolling CRC with window size
+            @param:  _window_size - const std::size_t, window size in bytes
+        */
+        explicit crc_rolling(const std::size_t _window_size) noexcept : m_window_size(_window_size) {
+            using namespace ubn::authlib::detail;
+
+            constexpr uint8_t zero { 0x00 };
+
+            // Register of n and n + 1 zero bytes from init, sliding xors both in to keep the init contribution
+            auto init_n { crc_init<T> };
+            for (std::size_t i = 0; i != _window_size; ++i) { init_n = updateCRCCode<T>(init_n, &zero, 1); }
+            const auto init_contribution { static_cast<value_type>(init_n ^ updateCRCCode<T>(init_n, &zero, 1)) };
+
+            // Contribution of a byte leaving the window is linear in its bits
+            std::array<value_type, 8> bit_contribution;
+            for (std::size_t bit = 0; bit != 8; ++bit) {
+                const uint8_t byte { static_cast<uint8_t>(0x01 << bit) };
+                auto          crc  { updateCRCCode<T>(0, &byte, 1) };
+                for (std::size_t i = 0; i != _window_size; ++i) { crc = updateCRCCode<T>(crc, &zero, 1); }
+                bit_contribution[bit] = crc;
+            }
+            for (std::size_t byte = 0; byte != 256; ++byte) {
+                auto contribution { init_contribution };
+                for (std::size_t bit = 0; bit != 8; ++bit) {
+                    if (byte >> bit & 0x01) { contribution ^= bit_contribution[bit]; }
+                }
+                m_out_table[byte] = contribution;
+            }
+        }
+
+        /*
+            @brief: Feed data to fill the window
+            @param:  _data         - const uint8_t *, data to feed
+            @param:  _size         - const std::size_t, size of data, should fill the window exactly before rolling
+            @return: crc_rolling & - this rolling CRC
+        */
+        crc_rolling& update(const uint8_t* _data, const std::size_t _size) noexcept {
+            m_crc_code = authlib::detail::updateCRCCodeKernel<T>(m_crc_code, _data, _size);
+            return *this;
+        }
+
+        /*
+            @brief: Slide the window by one byte
+            @param:  _out          - const uint8_t, oldest byte leaving the window
+            @param:  _in           - const uint8_t, new byte entering the window
+            @return: crc_rolling & - this rolling CRC
+        */
+        crc_rolling& roll(const uint8_t _out, const uint8_t _in) noexcept {
+            m_crc_code = authlib::detail::updateCRCCode<T>(m_crc_code, &_in, 1) ^ m_out_table[_out];
+            return *this;
+        }
+
+        /*
+            @brief: Get CRC checksum of the current window
+            @return: value_type - CRC checksum
+        */
+        constexpr value_type value() const noexcept {
+            return static_cast<value_type>(m_crc_code ^ authlib::detail::crc_model<T>.xor_out);
+        }
+
+        /*
+            @brief: Reset to an empty window
+        */
+        constexpr void reset() noexcept { m_crc_code = authlib::detail::crc_init<T>; }
+
+        /*
+            @brief: Get window size
+            @return: std::size_t - window size in bytes
+        */
+        constexpr std::size_t window_size() const noexcept { return m_window_size; }
+
+    private:
+        std::size_t                 m_window_size;
+        value_type                  m_crc_code { authlib::detail::crc_init<T> };
+        std::array<value_type, 256> m_out_table;
+    };
+
+    /*
+        @brief: Find the first fixed length frame whose trailing CRC code matches, sliding a rolling CRC over the stream
+        @param:  _stream       - const std::span<const uint8_t>, raw byte stream
+        @param:  _payload_size - const std::size_t, frame payload size in bytes, followed by the CRC code
+        @param:  _crc_order    - const std::endian, byte order of the trailing CRC code, little for reflected CRC by default
+        @return: std::size_t   - offset of the frame in stream, SIZE_MAX if not found
+    */
+    template <crc_types T, std::enable_if_t<std::is_same_v<decltype(T), crc_types>, bool> = true>
+    std::size_t crc_frame_sync(
+        const std::span<const uint8_t> _stream,
+        const std::size_t              _payload_size,
+        const std::endian              _crc_order = authlib::detail::crc_model<T>.ref_out ? std::endian::little : std::endian::big
+    ) noexcept {
+        SERIALIB_TRACE_SPAN("authlib::crc_frame_sync");
+        using value_type = authlib::detail::CRCValue<T>;
+        constexpr std::size_t crc_size { sizeof(value_type) };
+
+        const std::size_t frame_size { _payload_size + crc_size };
+        if (_payload_size == 0 || _stream.size() < frame_size) { return SIZE_MAX; }
+
+        const auto read_crc_code = [&](const uint8_t* _data) {
+            value_type crc_code { 0 };
+            for (std::size_t i = 0; i != crc_size; ++i) {
+                const std::size_t shift { _crc_order == std::endian::little ? i * 8 : (crc_size - 1 - i) * 8 };
+                crc_code |= static_cast<value_type>(static_cast<value_type>(_data[i]) << shift);
+            }
+            return crc_code;
+        };
+
+        crc_rolling<T> rolling(_payload_size);
+        rolling.update(_stream.data(), _payload_size);
+        for (std::size_t offset = 0;; ++offset) {
+            if (rolling.value() == read_crc_code(_stream.data() + offset + _payload_size)) { return offset; }
+            if (offset + frame_size == _stream.size()) {
+                SERIALIB_PROBE(authlib, crc_sync_fail, _stream.size(), _payload_size);
+                return SIZE_MAX;
+            }
+            rolling.roll(_stream[offset], _stream[offset + _payload_size]);
+        }
+    }
+
+    namespace authlib::detail {
+        // CRC register arithmetic in GF(2)[x] / P(x), reflected CRC keeps the highest degree coefficient in the lowest bit
+        template <CRCTypes T>
+        constexpr CRCValue<T> unityCRCCode() noexcept {
+            constexpr std::size_t bits { sizeof(CRCValue<T>) * 8 };
+            return static_cast<CRCValue<T>>(crc_model<T>.ref_in ? static_cast<CRCValue<T>>(0x01) << (bits - 1) : 0x01);
+        }
+
+        template <CRCTypes T>
+        constexpr CRCValue<T> multiplyCRCCode(CRCValue<T> _lhs, const CRCValue<T> _rhs) noexcept {
+            constexpr std::size_t bits       { sizeof(CRCValue<T>) * 8 };
+            constexpr auto        model      { crc_model<T> };
+            constexpr auto        polynomial { model.ref_in ? binaryReverse<bits>(model.polynomial) : model.polynomial };
+
+            // Walk rhs from its lowest degree coefficient, doubling lhs by x each step
+            CRCValue<T> product { 0 };
+            for (std::size_t degree = 0; degree != bits; ++degree) {
+                const std::size_t bit { model.ref_in ? bits - 1 - degree : degree };
+                if (_rhs >> bit & 0x01) { product ^= _lhs; }
+                if constexpr (model.ref_in) { _lhs = _lhs & 0x01 ? (_lhs >> 1) ^ polynomial : _lhs >> 1; }
+                else { _lhs = _lhs >> (bits - 1) & 0x01 ? static_cast<CRCValue<T>>(_lhs << 1) ^ polynomial : static_cast<CRCValue<T>>(_lhs << 1); }
+            }
+
+            return product;
+        }
+
+        template <CRCTypes T>
+        constexpr CRCValue<T> shiftCRCCode(const CRCValue<T> _crc_code, std::size_t _zeros) noexcept {
+            constexpr uint8_t zero { 0x00 };
+
+            // x^(8 * zeros) by square and multiply, appending a zero byte to the unity register yields x^8
+            auto power { unityCRCCode<T>() };
+            auto base  { updateCRCCode<T>(unityCRCCode<T>(), &zero, 1) };
+            for (; _zeros != 0; _zeros >>= 1) {
+                if (_zeros & 0x01) { power = multiplyCRCCode<T>(power, base); }
+                base = multiplyCRCCode<T>(base, base);
+            }
+
+            return multiplyCRCCode<T>(_crc_code, power);
+        }
+    }
+
+    /*
+        @brief: Patch a cached CRC code after bytes at a known offset changed, without recomputing the whole frame
+        @param:  _crc_code - const CRCValue<T>, cached CRC code of the frame before the change
+        @param:  _size     - const std::size_t, frame size in bytes
+        @param:  _offset   - const std::size_t, offset of the changed bytes in frame
+        @param:  _old      - const std::span<const uint8_t>, bytes before the change
+        @param:  _new      - const std::span<const uint8_t>, bytes after the change, same size as _old
+        @return: auto      - CRC code of the frame after the change, O(changed bytes + log size),
+                             _crc_code unchanged if the sizes differ or the changed bytes are not inside the frame
+    */
+    template <crc_types T, std::enable_if_t<std::is_same_v<decltype(T), crc_types>, bool> = true>
+    auto crc_patch(
+        const authlib::detail::CRCValue<T> _crc_code,
+        const std::size_t                  _size,
+        const std::size_t                  _offset,
+        const std::span<const uint8_t>     _old,
+        const std::span<const uint8_t>     _new
+    ) noexcept {
+        using namespace ubn::authlib::detail;
+
+        if (_old.size() != _new.size() || _old.size() > _size || _offset > _size - _old.size()) { return _crc_code; }
+
+        // CRC is linear, crc(M ^ D) = crc(M) ^ crc(D) with zero init and xor_out, and D's trailing zeros only shift the register
+        CRCValue<T> difference { 0 };
+        for (std::size_t i = 0; i != _old.size(); ++i) {
+            const uint8_t byte { static_cast<uint8_t>(_old[i] ^ _new[i]) };
+            difference = updateCRCCode<T>(difference, &byte, 1);
+        }
+
+        return static_cast<CRCValue<T>>(_crc_code ^ shiftCRCCode<T>(difference, _size - _offset - _old.size()));
+    }
+
+    namespace authlib::detail {
+        inline constexpr std::array<uint32_t, 64> sha256_k {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+
+        inline constexpr std::array<uint32_t, 8> sha256_init {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+        };
+
+        using SHA256Transform = void (*)(uint32_t*, const uint8_t*, std::size_t) noexcept;
+
+        inline void transformSHA256(uint32_t* _state, const uint8_t* _data, std::size_t _blocks) noexcept {
+            for (; _blocks != 0; --_blocks, _data += 64) {
+                std::array<uint32_t, 64> w;
+                for (std::size_t i = 0; i != 16; ++i) {
+                    w[i] = static_cast<uint32_t>(_data[i * 4]) << 24 | static_cast<uint32_t>(_data[i * 4 + 1]) << 16 |
+                           static_cast<uint32_t>(_data[i * 4 + 2]) << 8 | static_cast<uint32_t>(_data[i * 4 + 3]);
+                }
+                for (std::size_t i = 16; i != 64; ++i) {
+                    const uint32_t s0 { std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3) };
+                    const uint32_t s1 { std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10) };
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+
+                auto [a, b, c, d, e, f, g, h] { std::to_array({ _state[0], _state[1], _state[2], _state[3], _state[4], _state[5], _state[6], _state[7] }) };
+                for (std::size_t i = 0; i != 64; ++i) {
+                    const uint32_t t1 { h + (std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i] };
+                    const uint32_t t2 { (std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c)) };
+                    h = g; g = f; f = e; e = d + t1;
+                    d = c; c = b; b = a; a = t1 + t2;
+                }
+
+                _state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+                _state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+            }
+        }
+
+#if defined(__x86_64__) || defined(__i386__)
+        __attribute__((target("sha,sse4.1")))
+        inline void transformSHA256NI(uint32_t* _state, const uint8_t* _data, std::size_t _blocks) noexcept {
+            const __m128i mask { _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL) };
+
+            // Rearrange state from ABCD EFGH to ABEF CDGH as required by sha256rnds2
+            __m128i tmp    { _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_state)), 0xb1) };
+            __m128i state1 { _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_state + 4)), 0x1b) };
+            __m128i state0 { _mm_alignr_epi8(tmp, state1, 8) };
+            state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+            for (; _blocks != 0; --_blocks, _data += 64) {
+                const __m128i abef { state0 };
+                const __m128i cdgh { state1 };
+
+                // Four rounds per group, message schedule w[i] = msg2(msg1(w[i - 4], w[i - 3]) + alignr(w[i - 1], w[i - 2]), w[i - 1])
+                __m128i w[4];
+                for (std::size_t i = 0; i != 16; ++i) {
+                    if (i < 4) {
+                        w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_data + i * 16)), mask);
+                    } else {
+                        w[i % 4] = _mm_sha256msg2_epu32(
+                            _mm_add_epi32(_mm_sha256msg1_epu32(w[i % 4], w[(i + 1) % 4]), _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4)),
+                            w[(i + 3) % 4]
+                        );
+                    }
+                    __m128i msg { _mm_add_epi32(w[i % 4], _mm_loadu_si128(reinterpret_cast<const __m128i*>(sha256_k.data() + i * 4))) };
+                    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+                    msg    = _mm_shuffle_epi32(msg, 0x0e);
+                    state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+                }
+
+                state0 = _mm_add_epi32(state0, abef);
+                state1 = _mm_add_epi32(state1, cdgh);
+            }
+
+            // Rearrange state back to ABCD EFGH
+            tmp    = _mm_shuffle_epi32(state0, 0x1b);
+            state1 = _mm_shuffle_epi32(state1, 0xb1);
+            state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+            state1 = _mm_alignr_epi8(state1, tmp, 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(_state), state0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(_state + 4), state1);
+        }
+#endif
+
+        inline SHA256Transform selectSHA256Transform() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            // SHA-NI is cpuid leaf 7 ebx bit 29, SSSE3 and SSE4.1 are leaf 1 ecx bits 9 and 19
+            unsigned int eax { 0 }, ebx { 0 }, ecx { 0 }, edx { 0 };
+            if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSSE3) && (ecx & bit_SSE4_1) &&
+                __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA)) {
+                return &transformSHA256NI;
+            }
+#endif
+            return &transformSHA256;
+        }
+
+        inline const SHA256Transform sha256_transform { selectSHA256Transform() };
+    }
+
+    /*
+        @brief: Streaming SHA-256, uses SHA-NI when the CPU supports it
+    */
+    class sha256 {
+    public:
+        using value_type = std::array<uint8_t, 32>;
+
+        /*
+            @brief: Default constructor of sha256 with the initial hash state
+        */
+        constexpr sha256() noexcept = default;
+
+        /*
+            @brief: Feed data to the hash state
+            @param:  _data    - const uint8_t *, data to feed
+            @param:  _size    - std::size_t, size of data
+            @return: sha256 & - this hash state
+        */
+        sha256& update(const uint8_t* _data, std::size_t _size) noexcept {
+            using namespace ubn::authlib::detail;
+
+            m_size += _size;
+            if (m_block_size != 0) {
+                const std::size_t fill { std::min(_size, m_block.size() - m_block_size) };
+                std::memcpy(m_block.data() + m_block_size, _data, fill);
+                m_block_size += fill;
+                _data        += fill;
+                _size        -= fill;
+                if (m_block_size != m_block.size()) { return *this; }
+                sha256_transform(m_state.data(), m_block.data(), 1);
+                m_block_size = 0;
+            }
+
+            // Whole blocks straight from input, keep the tail
+            sha256_transform(m_state.data(), _data, _size / 64);
+            m_block_size = _size % 64;
+            std::memcpy(m_block.data(), _data + _size - m_block_size, m_block_size);
+
+            return *this;
+        }
+
+        /*
+            @brief: Feed a contiguous range of byte sized elements to the hash state
+            @param:  _str     - const V &, std::string_view, std::span<const std::byte>, etc.
+            @return: sha256 & - this hash state
+        */
+        template <typename V, std::enable_if_t<authlib::detail::ByteRange<V>, bool> = true>
+        sha256& update(const V& _str) noexcept {
+            return update(reinterpret_cast<const uint8_t*>(std::ranges::data(_str)), std::ranges::size(_str));
+        }
+
+        /*
+            @brief: Get SHA-256 digest of all data fed so far, the state is not modified
+            @return: value_type - 32 bytes digest
+        */
+        value_type value() const noexcept {
+            using namespace ubn::authlib::detail;
+
+            // Pad with 0x80, zeros and the message bit length in big endian
+            auto                     state { m_state };
+            std::array<uint8_t, 128> tail  {};
+            const std::size_t        size  { m_block_size < 56 ? 64u : 128u };
+            const uint64_t           bits  { m_size * 8 };
+            std::memcpy(tail.data(), m_block.data(), m_block_size);
+            tail[m_block_size] = 0x80;
+            for (std::size_t i = 0; i != 8; ++i) { tail[size - 1 - i] = static_cast<uint8_t>(bits >> (i * 8)); }
+            sha256_transform(state.data(), tail.data(), size / 64);
+
+            value_type digest;
+            for (std::size_t i = 0; i != digest.size(); ++i) { digest[i] = static_cast<uint8_t>(state[i / 4] >> (24 - i % 4 * 8)); }
+
+            return digest;
+        }
+
+        /*
+            @brief: Reset to the initial hash state
+        */
+        constexpr void reset() noexcept {
+            m_state      = authlib::detail::sha256_init;
+            m_block_size = 0;
+            m_size       = 0;
+        }
+
+    private:
+        std::array<uint32_t, 8> m_state      { authlib::detail::sha256_init };
+        std::array<uint8_t, 64> m_block      {};
+        std::size_t             m_block_size { 0 };
+        uint64_t                m_size       { 0 };
+    };
+
+    /*
+        @brief: Generate SHA-256 digest
+        @param:  _data               - const uint8_t *, data to hash
+        @param:  _size               - const std::size_t, size of data
+        @return: sha256::value_type  - 32 bytes digest
+    */
+    inline sha256::value_type sha256_gen(const uint8_t* _data, const std::size_t _size) noexcept {
+        return sha256().update(_data, _size).value();
+    }
+
+    /*
+        @brief: Generate SHA-256 digest
+        @param:  _str                - const V &, std::string_view, std::span<const std::byte>, etc.
+        @return: sha256::value_type  - 32 bytes digest
+    */
+    template <typename V, std::enable_if_t<authlib::detail::ByteRange<V>, bool> = true>
+    sha256::value_type sha256_gen(const V& _str) noexcept {
+        return sha256().update(_str).value();
+    }
+
+    namespace authlib::detail {
+        inline void roundSipHash(std::array<uint64_t, 4>& v_) noexcept {
+            v_[0] += v_[1]; v_[1] = std::rotl(v_[1], 13); v_[1] ^= v_[0]; v_[0] = std::rotl(v_[0], 32);
+            v_[2] += v_[3]; v_[3] = std::rotl(v_[3], 16); v_[3] ^= v_[2];
+            v_[0] += v_[3]; v_[3] = std::rotl(v_[3], 21); v_[3] ^= v_[0];
+            v_[2] += v_[1]; v_[1] = std::rotl(v_[1], 17); v_[1] ^= v_[2]; v_[2] = std::rotl(v_[2], 32);
+        }
+    }
+
+    /*
+        @brief: Streaming SipHash-2-4 keyed MAC, fast for short frames
+    */
+    class siphash {
+    public:
+        using value_type = std::array<uint8_t, 8>;
+
+        /*
+            @brief: Init SipHash with 16 bytes key
+            @param:  _key - const std::span<const uint8_t, 16>, secret key
+        */
+        explicit siphash(const std::span<const uint8_t, 16> _key) noexcept {
+            using namespace ubn::authlib::detail;
+
+            const uint64_t k0 { loadU64LE(_key.data()) };
+            const uint64_t k1 { loadU64LE(_key.data() + 8) };
+            m_init = { k0 ^ 0x736f6d6570736575, k1 ^ 0x646f72616e646f6d, k0 ^ 0x6c7967656e657261, k1 ^ 0x7465646279746573 };
+            m_v    = m_init;
+        }
+
+        /*
+            @brief: Feed data to the MAC state
+            @param:  _data     - const uint8_t *, data to feed
+            @param:  _size     - std::size_t, size of data
+            @return: siphash & - this MAC state
+        */
+        siphash& update(const uint8_t* _data, std::size_t _size) noexcept {
+            using namespace ubn::authlib::detail;
+
+            m_size += _size;
+            if (m_block_size != 0) {
+                const std::size_t fill { std::min(_size, m_block.size() - m_block_size) };
+                std::memcpy(m_block.data() + m_block_size, _data, fill);
+                m_block_size += fill;
+                _data        += fill;
+                _size        -= fill;
+                if (m_block_size != m_block.size()) { return *this; }
+                compress(loadU64LE(m_block.data()));
+                m_block_size = 0;
+            }
+
+            for (; _size >= 8; _size -= 8, _data += 8) { compress(loadU64LE(_data)); }
+            m_block_size = _size;
+            std::memcpy(m_block.data(), _data, _size);
+
+            return *this;
+        }
+
+        /*
+            @brief: Feed a contiguous range of byte sized elements to the MAC state
+            @param:  _str      - const V &, std::string_view, std::span<const std::byte>, etc.
+            @return: siphash & - this MAC state
+        */
+        template <typename V, std::enable_if_t<authlib::detail::ByteRange<V>, bool> = true>
+        siphash& update(const V& _str) noexcept {
+            return update(reinterpret_cast<const uint8_t*>(std::ranges::data(_str)), std::ranges::size(_str));
+        }
+
+        /*
+            @brief: Get tag of all data fed so far, the state is not modified
+            @return: value_type - 8 bytes tag, little endian
+        */
+        value_type value() const noexcept {
+            using namespace ubn::authlib::detail;
+
+            // Last block holds the remaining bytes and the message length modulo 256 in its highest byte
+            std::array<uint8_t, 8> last {};
+            std::memcpy(last.data(), m_block.data(), m_block_size);
+            last[7] = static_cast<uint8_t>(m_size);
+
+            siphash state { *this };
+            state.compress(loadU64LE(last.data()));
+            state.m_v[2] ^= 0xff;
+            for (std::size_t i = 0; i != 4; ++i) { roundSipHash(state.m_v); }
+
+            const uint64_t tag { state.m_v[0] ^ state.m_v[1] ^ state.m_v[2] ^ state.m_v[3] };
+            value_type     bytes;
+            for (std::size_t i = 0; i != bytes.size(); ++i) { bytes[i] = static_cast<uint8_t>(tag >> (i * 8)); }
+
+            return bytes;
+        }
+
+        /*
+            @brief: Reset to the keyed initial state, no need to re-derive from the key
+        */
+        void reset() noexcept {
+            m_v          = m_init;
+            m_block_size = 0;
+            m_size       = 0;
+        }
+
+    private:
+        void compress(const uint64_t _m) noexcept {
+            m_v[3] ^= _m;
+            authlib::detail::roundSipHash(m_v);
+            authlib::detail::roundSipHash(m_v);
+            m_v[0] ^= _m;
+        }
+
+        std::array<uint64_t, 4> m_init;
+        std::array<uint64_t, 4> m_v;
+        std::array<uint8_t, 8>  m_block      {};
+        std::size_t             m_block_size { 0 };
+        uint64_t                m_size       { 0 };
+    };
+
+    /*
+        @brief: Streaming HMAC-SHA256 keyed MAC, for bulk data
+    */
+    class hmac_sha256 {
+    public:
+        using value_type = sha256::value_type;
+
+        /*
+            @brief: Init HMAC-SHA256 with key, padded key blocks are hashed once here
+            @param:  _key - const std::span<const uint8_t>, secret key of any size
+        */
+        explicit hmac_sha256(const std::span<const uint8_t> _key) noexcept {
+            std::array<uint8_t, 64> key {};
+            if (_key.size() > key.size()) {
+                const auto digest { sha256_gen(_key.data(), _key.size()) };
+                std::memcpy(key.data(), digest.data(), digest.size());
+            } else {
+                std::memcpy(key.data(), _key.data(), _key.size());
+            }
+
+            std::array<uint8_t, 64> pad;
+            for (std::size_t i = 0; i != pad.size(); ++i) { pad[i] = key[i] ^ 0x36; }
+            m_inner_init.update(pad.data(), pad.size());
+            for (std::size_t i = 0; i != pad.size(); ++i) { pad[i] = key[i] ^ 0x5c; }
+            m_outer_init.update(pad.data(), pad.size());
+            m_inner = m_inner_init;
+        }
+
+        /*
+            @brief: Feed data to the MAC state
+            @param:  _data         - const uint8_t *, data to feed
+            @param:  _size         - const std::size_t, size of data
+            @return: hmac_sha256 & - this MAC state
+        */
+        hmac_sha256& update(const uint8_t* _data, const std::size_t _size) noexcept {
+            m_inner.update(_data, _size);
+            return *this;
+        }
+
+        /*
+            @brief: Feed a contiguous range of byte sized elements to the MAC state
+            @param:  _str          - const V &, std::string_view, std::span<const std::byte>, etc.
+            @return: hmac_sha256 & - this MAC state
+        */
+        template <typename V, std::enable_if_t<authlib::detail::ByteRange<V>, bool> = true>
+        hmac_sha256& update(const V& _str) noexcept {
+            m_inner.update(_str);
+            return *this;
+        }
+
+        /*
+            @brief: Get tag of all data fed so far, the state is not modified
+            @return: value_type - 32 bytes tag
+        */
+        value_type value() const noexcept {
+            const auto inner { m_inner.value() };
+            return sha256(m_outer_init).update(inner.data(), inner.size()).value();
+        }
+
+        /*
+            @brief: Reset to the keyed initial state, no need to re-derive from the key
+        */
+        void reset() noexcept { m_inner = m_inner_init; }
+
+    private:
+        sha256 m_inner_init;
+        sha256 m_outer_init;
+        sha256 m_inner;
+    };
+
+    /*
+        @brief: Append a truncated MAC tag to frame
+        @param:  _mac      - const M &, siphash or hmac_sha256 in its keyed initial state, copied per frame
+        @param:  frame_    - std::string &, frame to append the tag to
+        @param:  _tag_size - const std::size_t, tag size in bytes, truncated to at most the full tag size
+        @return: bool      - whether the tag is appended
+    */
+    template <typename M, std::enable_if_t<std::is_same_v<M, siphash> || std::is_same_v<M, hmac_sha256>, bool> = true>
+    bool mac_append(const M& _mac, std::string& frame_, const std::size_t _tag_size) noexcept {
+        const auto tag { M(_mac).update(frame_).value() };
+        if (_tag_size == 0 || _tag_size > tag.size()) { return false; }
+        frame_.append(reinterpret_cast<const char*>(tag.data()), _tag_size);
+
+        return true;
+    }
+
+    /*
+        @brief: Verify the truncated MAC tag trailing frame in constant time
+        @param:  _mac      - const M &, siphash or hmac_sha256 in its keyed initial state, copied per frame
+        @param:  _frame    - const std::string_view, frame followed by the tag
+        @param:  _tag_size - const std::size_t, tag size in bytes
+        @return: bool      - whether the tag matches
+    */
+    template <typename M, std::enable_if_t<std::is_same_v<M, siphash> || std::is_same_v<M, hmac_sha256>, bool> = true>
+    bool mac_verify(const M& _mac, const std::string_view _frame, const std::size_t _tag_size) noexcept {
+        SERIALIB_TRACE_SPAN("authlib::mac_verify");
+        const auto tag { M(_mac).update(_frame.substr(0, _frame.size() - std::min(_tag_size, _frame.size()))).value() };
+        if (_tag_size == 0 || _tag_size > tag.size() || _tag_size > _frame.size()) { return false; }
+
+        uint8_t difference { 0 };
+        for (std::size_t i = 0; i != _tag_size; ++i) {
+            difference |= tag[i] ^ static_cast<uint8_t>(_frame[_frame.size() - _tag_size + i]);
+        }
+
+        if (difference != 0) { SERIALIB_PROBE(authlib, mac_fail, _frame.size(), _tag_size); }
+        return difference == 0;
+    }
+
+    namespace authlib::detail {
+        inline constexpr uint64_t xxh_prime32_1 { 0x9e3779b1 };
+        inline constexpr uint64_t xxh_prime32_2 { 0x85ebca77 };
+        inline constexpr uint64_t xxh_prime32_3 { 0xc2b2ae3d };
+        inline constexpr uint64_t xxh_prime64_1 { 0x9e3779b185ebca87 };
+        inline constexpr uint64_t xxh_prime64_2 { 0xc2b2ae3d27d4eb4f };
+        inline constexpr uint64_t xxh_prime64_3 { 0x165667b19e3779f9 };
+        inline constexpr uint64_t xxh_prime64_4 { 0x85ebca77c2b2ae63 };
+        inline constexpr uint64_t xxh_prime64_5 { 0x27d4eb2f165667c5 };
+        inline constexpr uint64_t xxh_prime_mx1 { 0x165667919e3779f9 };
+        inline constexpr uint64_t xxh_prime_mx2 { 0x9fb21c651e98df25 };
+
+        inline constexpr std::array<uint8_t, 192> xxh3_secret {
+            0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+            0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+            0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+            0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+            0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+            0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+            0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+            0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+            0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+            0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+            0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+            0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+        };
+
+        inline uint32_t loadU32LE(const uint8_t* _data) noexcept {
+            return static_cast<uint32_t>(_data[0]) | static_cast<uint32_t>(_data[1]) << 8 |
+                   static_cast<uint32_t>(_data[2]) << 16 | static_cast<uint32_t>(_data[3]) << 24;
+        }
+
+        inline uint64_t foldMultiplyXXH(const uint64_t _lhs, const uint64_t _rhs) noexcept {
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 product { static_cast<unsigned __int128>(_lhs) * _rhs };
+            return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+            // 32 x 32 partial products as in the reference XXH_mult64to128 for targets without 128 bits integers
+            const uint64_t lo_lo { (_lhs & 0xffffffff) * (_rhs & 0xffffffff) };
+            const uint64_t hi_lo { (_lhs >> 32)        * (_rhs & 0xffffffff) };
+            const uint64_t lo_hi { (_lhs & 0xffffffff) * (_rhs >> 32) };
+            const uint64_t hi_hi { (_lhs >> 32)        * (_rhs >> 32) };
+            const uint64_t cross { (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi };
+            const uint64_t upper { (hi_lo >> 32) + (cross >> 32) + hi_hi };
+            const uint64_t lower { (cross << 32) | (lo_lo & 0xffffffff) };
+            return lower ^ upper;
+#endif
+        }
+
+        inline uint64_t avalancheXXH64(uint64_t _hash) noexcept {
+            _hash ^= _hash >> 33; _hash *= xxh_prime64_2;
+            _hash ^= _hash >> 29; _hash *= xxh_prime64_3;
+            return _hash ^ (_hash >> 32);
+        }
+
+        inline uint64_t avalancheXXH3(uint64_t _hash) noexcept {
+            _hash ^= _hash >> 37; _hash *= xxh_prime_mx1;
+            return _hash ^ (_hash >> 32);
+        }
+
+        inline uint64_t mix16BXXH3(const uint8_t* _data, const uint8_t* _secret, const uint64_t _seed) noexcept {
+            return foldMultiplyXXH(loadU64LE(_data) ^ (loadU64LE(_secret) + _seed), loadU64LE(_data + 8) ^ (loadU64LE(_secret + 8) - _seed));
+        }
+
+        using XXH3Accumulate = void (*)(uint64_t*, const uint8_t*, const uint8_t*, std::size_t) noexcept;
+        using XXH3Scramble   = void (*)(uint64_t*, const uint8_t*) noexcept;
+
+        inline void accumulateXXH3(uint64_t* acc_, const uint8_t* _data, const uint8_t* _secret, const std::size_t _stripes) noexcept {
+            for (std::size_t stripe = 0; stripe != _stripes; ++stripe, _data += 64, _secret += 8) {
+                for (std::size_t i = 0; i != 8; ++i) {
+                    const uint64_t value { loadU64LE(_data + i * 8) };
+                    const uint64_t key   { value ^ loadU64LE(_secret + i * 8) };
+                    acc_[i ^ 1] += value;
+                    acc_[i]     += (key & 0xffffffff) * (key >> 32);
+                }
+            }
+        }
+
+        inline void scrambleXXH3(uint64_t* acc_, const uint8_t* _secret) noexcept {
+            for (std::size_t i = 0; i != 8; ++i) {
+                acc_[i] = (acc_[i] ^ (acc_[i] >> 47) ^ loadU64LE(_secret + i * 8)) * xxh_prime32_1;
+            }
+        }
+
+#if defined(__x86_64__) || defined(__i386__)
+        __attribute__((target("avx2")))
+        inline void accumulateXXH3AVX2(uint64_t* acc_, const uint8_t* _data, const uint8_t* _secret, const std::size_t _stripes) noexcept {
+            auto* acc { reinterpret_cast<__m256i*>(acc_) };
+            __m256i acc_lo { _mm256_loadu_si256(acc) };
+            __m256i acc_hi { _mm256_loadu_si256(acc + 1) };
+            for (std::size_t stripe = 0; stripe != _stripes; ++stripe, _data += 64, _secret += 8) {
+                for (__m256i* lane : { &acc_lo, &acc_hi }) {
+                    const std::size_t offset { lane == &acc_lo ? 0u : 32u };
+                    const __m256i     value  { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_data + offset)) };
+                    const __m256i     key    { _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_secret + offset))) };
+                    // 32 x 32 -> 64 bits multiply of key halves, value added to the neighbour lane
+                    const __m256i     product { _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32)) };
+                    *lane = _mm256_add_epi64(_mm256_add_epi64(*lane, _mm256_shuffle_epi32(value, 0x4e)), product);
+                }
+            }
+            _mm256_storeu_si256(acc, acc_lo);
+            _mm256_storeu_si256(acc + 1, acc_hi);
+        }
+
+        __attribute__((target("avx2")))
+        inline void scrambleXXH3AVX2(uint64_t* acc_, const uint8_t* _secret) noexcept {
+            const __m256i prime { _mm256_set1_epi32(static_cast<int>(xxh_prime32_1)) };
+            for (std::size_t offset = 0; offset != 64; offset += 32) {
+                auto*         acc   { reinterpret_cast<__m256i*>(reinterpret_cast<uint8_t*>(acc_) + offset) };
+                const __m256i value { _mm256_loadu_si256(acc) };
+                const __m256i key   { _mm256_xor_si256(
+                    _mm256_xor_si256(value, _mm256_srli_epi64(value, 47)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_secret + offset))
+                ) };
+                const __m256i lo    { _mm256_mul_epu32(key, prime) };
+                const __m256i hi    { _mm256_mul_epu32(_mm256_srli_epi64(key, 32), prime) };
+                _mm256_storeu_si256(acc, _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+            }
+        }
+#endif
+
+        inline std::pair<XXH3Accumulate, XXH3Scramble> selectXXH3Kernel() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) { return { &accumulateXXH3AVX2, &scrambleXXH3AVX2 }; }
+#endif
+            return { &accumulateXXH3, &scrambleXXH3 };
+        }
+
+        inline const std::pair<XXH3Accumulate, XXH3Scramble> xxh3_kernel { selectXXH3Kernel() };
+
+        inline uint64_t generateXXH3Long(const uint8_t* _data, const std::size_t _size, const uint8_t* _secret) noexcept {
+            constexpr std::size_t secret_size       { xxh3_secret.size() };
+            constexpr std::size_t stripes_per_block { (secret_size - 64) / 8 };
+            constexpr std::size_t block_size        { stripes_per_block * 64 };
+
+            const auto [accumulate, scramble] { xxh3_kernel };
+            alignas(32) std::array<uint64_t, 8> acc {
+                xxh_prime32_3, xxh_prime64_1, xxh_prime64_2, xxh_prime64_3, xxh_prime64_4, xxh_prime32_2, xxh_prime64_5, xxh_prime32_1
+            };
+
+            const std::size_t blocks { (_size - 1) / block_size };
+            for (std::size_t block = 0; block != blocks; ++block) {
+                accumulate(acc.data(), _data + block * block_size, _secret, stripes_per_block);
+                scramble(acc.data(), _secret + secret_size - 64);
+            }
+            accumulate(acc.data(), _data + blocks * block_size, _secret, ((_size - 1) - blocks * block_size) / 64);
+            accumulate(acc.data(), _data + _size - 64, _secret + secret_size - 64 - 7, 1);
+
+            uint64_t hash { _size * xxh_prime64_1 };
+            for (std::size_t i = 0; i != 4; ++i) {
+                hash += foldMultiplyXXH(acc[i * 2] ^ loadU64LE(_secret + 11 + i * 16), acc[i * 2 + 1] ^ loadU64LE(_secret + 19 + i * 16));
+            }
+
+            return avalancheXXH3(hash);
+        }
+    }
+
+    /*
+        @brief: Generate 64 bits XXH3 hash, non-cryptographic and much faster than CRC, for dedup, caching and indexing
+        @param:  _data    - const uint8_t *, data to hash
+        @param:  _size    - const std::size_t, size of data
+        @param:  _seed    - const uint64_t, hash seed
+        @return: uint64_t - hash value, same as XXH3_64bits_withSeed
+    */
+    inline uint64_t xxh3_gen(const uint8_t* _data, const std::size_t _size, const uint64_t _seed = 0) noexcept {
+        using namespace ubn::authlib::detail;
+
+        const uint8_t* secret { xxh3_secret.data() };
+        if (_size == 0) {
+            return avalancheXXH64(_seed ^ loadU64LE(secret + 56) ^ loadU64LE(secret + 64));
+        }
+        if (_size <= 3) {
+            const uint32_t combined {
+                static_cast<uint32_t>(_data[0]) << 16 | static_cast<uint32_t>(_data[_size >> 1]) << 24 |
+                static_cast<uint32_t>(_data[_size - 1]) | static_cast<uint32_t>(_size) << 8
+            };
+            return avalancheXXH64(combined ^ ((loadU32LE(secret) ^ loadU32LE(secret + 4)) + _seed));
+        }
+        if (_size <= 8) {
+            const uint64_t seed  { _seed ^ static_cast<uint64_t>(__builtin_bswap32(static_cast<uint32_t>(_seed))) << 32 };
+            const uint64_t input { loadU32LE(_data + _size - 4) + (static_cast<uint64_t>(loadU32LE(_data)) << 32) };
+            uint64_t       hash  { input ^ ((loadU64LE(secret + 8) ^ loadU64LE(secret + 16)) - seed) };
+            hash ^= std::rotl(hash, 49) ^ std::rotl(hash, 24);
+            hash *= xxh_prime_mx2;
+            hash ^= (hash >> 35) + _size;
+            hash *= xxh_prime_mx2;
+            return hash ^ (hash >> 28);
+        }
+        if (_size <= 16) {
+            const uint64_t lo { loadU64LE(_data) ^ ((loadU64LE(secret + 24) ^ loadU64LE(secret + 32)) + _seed) };
+            const uint64_t hi { loadU64LE(_data + _size - 8) ^ ((loadU64LE(secret + 40) ^ loadU64LE(secret + 48)) - _seed) };
+            return avalancheXXH3(_size + __builtin_bswap64(lo) + hi + foldMultiplyXXH(lo, hi));
+        }
+        if (_size <= 128) {
+            // Pairs of 16 bytes from both ends towards the middle
+            uint64_t hash { _size * xxh_prime64_1 };
+            for (std::size_t i = (_size - 1) / 32 + 1; i-- != 0;) {
+                hash += mix16BXXH3(_data + i * 16, secret + i * 32, _seed);
+                hash += mix16BXXH3(_data + _size - (i + 1) * 16, secret + i * 32 + 16, _seed);
+            }
+            return avalancheXXH3(hash);
+        }
+        if (_size <= 240) {
+            uint64_t hash { _size * xxh_prime64_1 };
+            for (std::size_t i = 0; i != 8; ++i) { hash += mix16BXXH3(_data + i * 16, secret + i * 16, _seed); }
+            hash = avalancheXXH3(hash);
+
+            uint64_t tail { mix16BXXH3(_data + _size - 16, secret + 136 - 17, _seed) };
+            for (std::size_t i = 8; i != _size / 16; ++i) { tail += mix16BXXH3(_data + i * 16, secret + (i - 8) * 16 + 3, _seed); }
+            return avalancheXXH3(hash + tail);
+        }
+
+        if (_seed == 0) { return generateXXH3Long(_data, _size, secret); }
+
+        // Seeded long input uses a secret derived from the seed
+        std::array<uint8_t, xxh3_secret.size()> seeded_secret;
+        for (std::size_t i = 0; i != seeded_secret.size(); i += 8) {
+            const uint64_t word { loadU64LE(secret + i) + (i % 16 == 0 ? _seed : 0 - _seed) };
+            for (std::size_t j = 0; j != 8; ++j) { seeded_secret[i + j] = static_cast<uint8_t>(word >> (j * 8)); }
+        }
+        return generateXXH3Long(_data, _size, seeded_secret.data());
+    }
+
+    /*
+        @brief: Generate 64 bits XXH3 hash
+        @param:  _str     - const V &, std::string_view, std::span<const std::byte>, etc.
+        @param:  _seed    - const uint64_t, hash seed
+        @return: uint64_t - hash value, same as XXH3_64bits_withSeed
+    */
+    template <typename V, std::enable_if_t<authlib::detail::ByteRange<V>, bool> = true>
+    uint64_t xxh3_gen(const V& _str, const uint64_t _seed = 0) noexcept {
+        return xxh3_gen(reinterpret_cast<const uint8_t*>(std::ranges::data(_str)), std::ranges::size(_str), _seed);
+    }
 }
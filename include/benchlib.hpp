@@ -0,0 +1,789 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <iomanip>
+#include <charconv>
+#include <memory>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "serialib.hpp"
+#include "ptylib.hpp"
+#include "histlib.hpp"
+#include "simlib.hpp"
+
+extern "C" {
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/resource.h>
+}
+
+namespace ubn {
+    namespace benchlib::detail {
+        enum BenchAPIs {
+            send, read
+        };
+
+        enum BenchModes {
+            sync, async
+        };
+
+        // Syscalls issued by serialib itself, including FIONREAD ioctl(2) and poll(2) on the read path
+        inline uint64_t readSyscalls(const serialib& _serial) noexcept {
+            const serial_counters counters { _serial.counters() };
+            return counters.send_syscalls + counters.read_syscalls;
+        }
+
+        inline double readCPUTime() noexcept {
+            struct rusage usage {};
+            ::getrusage(RUSAGE_SELF, &usage);
+            return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+                   static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+        }
+
+        inline uint64_t nowNanoseconds() noexcept {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+            );
+        }
+
+        // Probe line is '#' + 8 hex sequence + 16 hex send timestamp, padded with '.' and terminated by '\n'
+        constexpr std::size_t probe_header_size { 1 + 8 + 16 };
+
+        inline void writeProbe(std::string& probe_, const uint32_t _sequence, const uint64_t _timestamp) noexcept {
+            constexpr char digits[] { "0123456789abcdef" };
+            probe_[0] = '#';
+            for (std::size_t i = 0; i != 8;  ++i) { probe_[1 + i] = digits[(_sequence  >> (28 - i * 4)) & 0xf]; }
+            for (std::size_t i = 0; i != 16; ++i) { probe_[9 + i] = digits[(_timestamp >> (60 - i * 4)) & 0xf]; }
+        }
+
+        inline bool parseProbe(const std::string_view _line, uint32_t& sequence_, uint64_t& timestamp_) noexcept {
+            if (_line.size() < probe_header_size || _line[0] != '#') { return false; }
+            const auto sequence  { std::from_chars(_line.data() + 1, _line.data() + 9,  sequence_,  16) };
+            const auto timestamp { std::from_chars(_line.data() + 9, _line.data() + 25, timestamp_, 16) };
+            return sequence.ec == std::errc() && sequence.ptr == _line.data() + 9 &&
+                   timestamp.ec == std::errc() && timestamp.ptr == _line.data() + 25;
+        }
+    }
+
+    using bench_apis  = benchlib::detail::BenchAPIs;
+    using bench_modes = benchlib::detail::BenchModes;
+
+    struct bench_result {
+        std::size_t messages             { 0 };
+        double      bytes_per_sec        { 0 };
+        double      syscalls_per_message { 0 };
+        double      p50_us               { 0 };
+        double      p99_us               { 0 };
+        double      p999_us              { 0 };
+        double      cpu_usage            { 0 };
+
+        /*
+            @brief: Operator << for std::ostream
+            @param: _os            - std::ostream &, output stream
+            @param: _rhs           - const bench_result &, benchmark result
+            @return: std::ostream & - output stream
+        */
+        friend std::ostream& operator<<(std::ostream& _os, const bench_result& _rhs) noexcept {
+            _os << "messages: "       << _rhs.messages
+                << ", bytes/s: "      << _rhs.bytes_per_sec
+                << ", syscalls/msg: " << _rhs.syscalls_per_message
+                << ", p50: "          << _rhs.p50_us  << "us"
+                << ", p99: "          << _rhs.p99_us  << "us"
+                << ", p999: "         << _rhs.p999_us << "us"
+                << ", cpu: "          << _rhs.cpu_usage * 100 << "%";
+            return _os;
+        }
+    };
+
+    /*
+        @brief: Benchmark serialib send or read API over a pseudo-terminal pair
+                Sends are drained by a peer thread on the master end, reads interleave non-blocking master writes with serialib reads
+        @param:  _api          - const bench_apis, API to drive, send (operator << / async_send) or read (operator >> / async_read)
+        @param:  _mode         - const bench_modes, sync operators or async futures
+        @param:  _message_size - const std::size_t, message size in bytes
+        @param:  _messages     - const std::size_t, number of messages, each is fully delivered before the next one is sent
+        @return: bench_result  - throughput, serialib syscalls per message from serial_counters, latency percentiles and process CPU usage
+    */
+    inline bench_result serial_bench(
+        const bench_apis  _api,
+        const bench_modes _mode,
+        const std::size_t _message_size,
+        const std::size_t _messages
+    ) noexcept {
+        using namespace ubn::benchlib::detail;
+        using clock = std::chrono::steady_clock;
+
+        bench_result result;
+        pty_pair     pty;
+        if (!pty.is_open() || _message_size == 0 || _messages == 0) { return result; }
+        serialib serial(pty.name(), 115200);
+        if (!serial.is_open() || !serial.raw_input(true)) { return result; }
+
+        // Every byte value, raw input passes flow control and CR bytes through
+        std::string message(_message_size, '\0');
+        for (std::size_t i = 0; i != _message_size; ++i) { message[i] = static_cast<char>(i); }
+        std::vector<uint64_t> latencies;
+        latencies.reserve(_messages);
+
+        // Messages larger than the pty buffer never block the benchmark thread, the send peer drains concurrently
+        std::atomic<uint64_t> progress { 0 };
+        std::jthread          peer;
+        if (_api == bench_apis::send) {
+            peer = std::jthread([&](std::stop_token _stop) {
+                std::string buffer(std::max<std::size_t>(_message_size, 4096), '\0');
+                while (!_stop.stop_requested()) {
+                    struct pollfd pfd { pty.master(), POLLIN, 0 };
+                    if (::poll(&pfd, 1, 10) <= 0) { continue; }
+                    const auto size { ::read(pty.master(), buffer.data(), buffer.size()) };
+                    if (size > 0) {
+                        progress.fetch_add(static_cast<uint64_t>(size), std::memory_order_release);
+                        progress.notify_one();
+                    }
+                }
+            });
+        } else {
+            ::fcntl(pty.master(), F_SETFL, ::fcntl(pty.master(), F_GETFL) | O_NONBLOCK);
+        }
+
+        const uint64_t syscalls_begin { readSyscalls(serial) };
+        const double   cpu_begin      { readCPUTime() };
+        const auto     wall_begin     { clock::now() };
+        for (std::size_t i = 0; i != _messages; ++i) {
+            const auto begin { clock::now() };
+            if (_api == bench_apis::send) {
+                if (_mode == bench_modes::sync) {
+                    serial << message;
+                } else {
+                    std::promise<std::string_view> pms;
+                    std::future<std::string_view>  ftr { pms.get_future() };
+                    pms.set_value(message);
+                    serial.async_send(std::move(ftr)).get();
+                }
+                const uint64_t delivered { (i + 1) * _message_size };
+                for (uint64_t received; (received = progress.load(std::memory_order_acquire)) < delivered;) {
+                    progress.wait(received, std::memory_order_acquire);
+                }
+            } else {
+                for (std::size_t received = 0, sent = 0; received < _message_size;) {
+                    // Unread bytes are pending whenever the master write would block, so the read below always makes progress
+                    if (sent < _message_size) {
+                        const auto size { ::write(pty.master(), message.data() + sent, _message_size - sent) };
+                        if (size > 0) { sent += static_cast<std::size_t>(size); }
+                    }
+                    std::string_view chunk;
+                    if (_mode == bench_modes::sync) {
+                        if (serial >> chunk) { received += chunk.size(); }
+                    } else {
+                        received += serial.async_read<std::string_view>().get().size();
+                    }
+                }
+            }
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - begin).count());
+        }
+        const double   wall     { std::chrono::duration<double>(clock::now() - wall_begin).count() };
+        const double   cpu      { readCPUTime() - cpu_begin };
+        const uint64_t syscalls { readSyscalls(serial) - syscalls_begin };
+        if (peer.joinable()) {
+            peer.request_stop();
+            peer.join();
+        }
+
+        std::ranges::sort(latencies);
+        const auto percentile = [&](const double _p) {
+            return static_cast<double>(latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(_p * latencies.size()))]) / 1e3;
+        };
+        result.messages             = _messages;
+        result.bytes_per_sec        = static_cast<double>(_message_size * _messages) / wall;
+        result.syscalls_per_message = static_cast<double>(syscalls) / static_cast<double>(_messages);
+        result.p50_us               = percentile(0.5);
+        result.p99_us               = percentile(0.99);
+        result.p999_us              = percentile(0.999);
+        result.cpu_usage            = cpu / wall;
+
+        return result;
+    }
+
+    struct ping_options {
+        std::size_t               count        { 1000 };
+        std::chrono::microseconds interval     { 0 };
+        std::size_t               payload_size { 64 };
+        bool                      busy_poll    { false };
+        std::chrono::milliseconds timeout      { 1000 };
+    };
+
+    struct ping_result {
+        std::size_t        sent     { 0 };
+        std::size_t        received { 0 };
+        std::size_t        lost     { 0 };
+        histogram_snapshot rtt;
+
+        /*
+            @brief: Operator << for std::ostream
+            @param: _os            - std::ostream &, output stream
+            @param: _rhs           - const ping_result &, ping result
+            @return: std::ostream & - output stream
+        */
+        friend std::ostream& operator<<(std::ostream& _os, const ping_result& _rhs) noexcept {
+            _os << "sent: " << _rhs.sent << ", received: " << _rhs.received << ", lost: " << _rhs.lost << ", rtt (ns):\n" << _rhs.rtt;
+            return _os;
+        }
+    };
+
+    /*
+        @brief: Echo every byte read from a file descriptor back to it until stop is requested, the peer for serial_ping over a pty loopback
+        @param:  _fd    - const int, file descriptor, e.g. pty_pair::master()
+        @param:  _stop  - std::stop_token, stop token, e.g. from std::jthread
+    */
+    inline void serial_echo(const int _fd, std::stop_token _stop) noexcept {
+        char buffer[4096];
+        while (!_stop.stop_requested()) {
+            struct pollfd pfd { _fd, POLLIN, 0 };
+            if (::poll(&pfd, 1, 10) <= 0) { continue; }
+            const auto size { ::read(_fd, buffer, sizeof(buffer)) };
+            for (ssize_t sent = 0; size > 0 && sent < size;) {
+                const auto written { ::write(_fd, buffer + sent, static_cast<std::size_t>(size - sent)) };
+                if (written > 0) { sent += written; }
+            }
+        }
+    }
+
+    /*
+        @brief: Send timestamped probes one at a time and measure the round trip through an echo peer
+        @param:  _serial      - const serialib &, opened serial port, the peer on the other end must echo every byte
+        @param:  _options     - const ping_options &, probe count, pacing interval between sends, payload size (at least 26), busy polling or poll(2) wakeups and per probe timeout
+        @return: ping_result  - sent, received and lost probes with round trip histogram in nanoseconds
+    */
+    inline ping_result serial_ping(const serialib& _serial, const ping_options& _options = {}) noexcept {
+        using namespace ubn::benchlib::detail;
+        using clock = std::chrono::steady_clock;
+
+        ping_result result;
+        if (!_serial.is_open() || _options.payload_size < probe_header_size + 1) { return result; }
+
+        histogram   rtt;
+        std::string probe(_options.payload_size, '.');
+        probe.back() = '\n';
+        std::string pending;
+        auto        next_send { clock::now() };
+        for (uint32_t sequence = 0; sequence != _options.count; ++sequence) {
+            std::this_thread::sleep_until(next_send);
+            next_send += _options.interval;
+
+            writeProbe(probe, sequence, nowNanoseconds());
+            if (!(_serial << probe)) { continue; }
+            ++result.sent;
+
+            // Drain lines until the probe comes back, stale echoes of timed out probes are dropped
+            bool       matched  { false };
+            const auto deadline { clock::now() + _options.timeout };
+            while (!matched && clock::now() < deadline) {
+                std::string_view chunk;
+                if (_options.busy_poll) {
+                    if (!(_serial >> chunk)) { continue; }
+                } else {
+                    const auto remaining { std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now()).count() };
+                    if (!_serial.read_wait(static_cast<int>(remaining) + 1) || !(_serial >> chunk)) { continue; }
+                }
+                const uint64_t arrival { nowNanoseconds() };
+                pending.append(chunk);
+
+                for (std::size_t end; !matched && (end = pending.find('\n')) != std::string::npos;) {
+                    uint32_t echoed_sequence  { 0 };
+                    uint64_t echoed_timestamp { 0 };
+                    if (parseProbe(std::string_view(pending).substr(0, end), echoed_sequence, echoed_timestamp) && echoed_sequence == sequence) {
+                        rtt.record(arrival - echoed_timestamp);
+                        matched = true;
+                    }
+                    pending.erase(0, end + 1);
+                }
+            }
+            if (matched) { ++result.received; } else { ++result.lost; }
+        }
+        result.rtt = rtt.snapshot();
+
+        return result;
+    }
+
+    struct load_options {
+        std::size_t               ports         { 100 };
+        std::size_t               frame_size    { 64 };
+        double                    bytes_per_sec { 11520 };
+        std::chrono::milliseconds duration      { 1000 };
+        std::size_t               readers       { 1 };
+    };
+
+    struct port_load_result {
+        std::string        name;
+        uint64_t           frames_sent     { 0 };
+        uint64_t           frames_received { 0 };
+        uint64_t           frames_lost     { 0 };
+        uint64_t           frames_corrupt  { 0 };
+        uint64_t           bytes_dropped   { 0 };
+        double             bytes_per_sec   { 0 };
+        histogram_snapshot latency;
+    };
+
+    struct load_result {
+        std::vector<port_load_result> ports;
+        double                        bytes_per_sec   { 0 };
+        uint64_t                      frames_received { 0 };
+        uint64_t                      frames_lost     { 0 };
+        uint64_t                      frames_corrupt  { 0 };
+        uint64_t                      bytes_dropped   { 0 };
+        histogram_snapshot            latency;
+
+        /*
+            @brief: Operator << for std::ostream, prints one row per port and the total
+            @param: _os            - std::ostream &, output stream
+            @param: _rhs           - const load_result &, load result
+            @return: std::ostream & - output stream
+        */
+        friend std::ostream& operator<<(std::ostream& _os, const load_result& _rhs) noexcept {
+            const auto row = [&_os](
+                const std::string_view _name, const double _bytes_per_sec, const uint64_t _received, const uint64_t _lost,
+                const uint64_t _corrupt, const uint64_t _dropped, const histogram_snapshot& _latency
+            ) {
+                _os << std::setw(14) << _name     << std::setw(12) << static_cast<uint64_t>(_bytes_per_sec)
+                    << std::setw(10) << _received << std::setw(8)  << _lost << std::setw(8) << _corrupt << std::setw(10) << _dropped
+                    << std::setw(10) << _latency.percentile(50) / 1000 << std::setw(10) << _latency.percentile(99) / 1000
+                    << std::setw(10) << _latency.max / 1000 << '\n';
+            };
+
+            _os << std::setw(14) << "port"   << std::setw(12) << "bytes/s" << std::setw(10) << "frames" << std::setw(8) << "lost"
+                << std::setw(8)  << "corrupt" << std::setw(10) << "dropped" << std::setw(10) << "p50(us)" << std::setw(10) << "p99(us)"
+                << std::setw(10) << "max(us)" << '\n';
+            for (const auto& port : _rhs.ports) {
+                row(port.name, port.bytes_per_sec, port.frames_received, port.frames_lost, port.frames_corrupt, port.bytes_dropped, port.latency);
+            }
+            row("total", _rhs.bytes_per_sec, _rhs.frames_received, _rhs.frames_lost, _rhs.frames_corrupt, _rhs.bytes_dropped, _rhs.latency);
+            return _os;
+        }
+    };
+
+    /*
+        @brief: Stream timestamped frames from many simulated devices into serialib instances and measure what each port delivers
+                One thread drives all devices, reader threads multiplex the serialib instances with poll(2)
+        @param:  _options    - const load_options &, ports, frame size (at least 26), per port stream rate, duration and reader threads
+        @return: load_result - per port and total delivered throughput, lost frames by sequence gap, corrupt frames,
+                               bytes dropped by devices when the host falls behind and first byte to frame delivered latency in nanoseconds
+    */
+    inline load_result serial_load(const load_options& _options = {}) noexcept {
+        using namespace ubn::benchlib::detail;
+        using clock = std::chrono::steady_clock;
+
+        struct LoadPort {
+            std::unique_ptr<sim_device> device;
+            std::unique_ptr<serialib>   serial;
+            histogram                   latency;
+            std::string                 pending;
+            uint32_t                    sent     { 0 };
+            uint32_t                    expected { 0 };
+            uint64_t                    received { 0 };
+            uint64_t                    lost     { 0 };
+            uint64_t                    corrupt  { 0 };
+            uint64_t                    bytes    { 0 };
+        };
+
+        load_result result;
+        if (_options.ports == 0 || _options.readers == 0 || _options.frame_size < probe_header_size + 1) { return result; }
+
+        std::vector<std::unique_ptr<LoadPort>> ports;
+        for (std::size_t i = 0; i != _options.ports; ++i) {
+            auto port { std::make_unique<LoadPort>() };
+            port->device = std::make_unique<sim_device>();
+            if (!port->device->is_open()) { return result; }
+            port->device->stream([&frame_size = _options.frame_size, &sent = port->sent] {
+                std::string frame(frame_size, '.');
+                frame.back() = '\n';
+                writeProbe(frame, sent++, nowNanoseconds());
+                return frame;
+            }, _options.bytes_per_sec);
+            port->serial = std::make_unique<serialib>(port->device->name(), 115200);
+            if (!port->serial->is_open()) { return result; }
+            ports.push_back(std::move(port));
+        }
+
+        const auto receive = [&frame_size = _options.frame_size](LoadPort& _port) {
+            std::string_view chunk;
+            if (!(*_port.serial >> chunk)) { return; }
+            const uint64_t arrival { nowNanoseconds() };
+            _port.bytes += chunk.size();
+            _port.pending.append(chunk);
+            for (std::size_t end; (end = _port.pending.find('\n')) != std::string::npos;) {
+                uint32_t sequence  { 0 };
+                uint64_t timestamp { 0 };
+                if (end + 1 == frame_size &&
+                    parseProbe(std::string_view(_port.pending).substr(0, end), sequence, timestamp) && sequence >= _port.expected) {
+                    _port.lost    += sequence - _port.expected;
+                    _port.expected = sequence + 1;
+                    ++_port.received;
+                    _port.latency.record(arrival - timestamp);
+                } else {
+                    ++_port.corrupt;
+                }
+                _port.pending.erase(0, end + 1);
+            }
+        };
+
+        std::atomic<bool> reading { true };
+        std::vector<std::jthread> readers;
+        for (std::size_t r = 0; r != _options.readers; ++r) {
+            readers.emplace_back([&, r] {
+                std::vector<struct pollfd> pfds;
+                std::vector<LoadPort*>     owners;
+                for (std::size_t i = r; i < ports.size(); i += _options.readers) {
+                    pfds.push_back({ ports[i]->serial->native_handle(), POLLIN, 0 });
+                    owners.push_back(ports[i].get());
+                }
+                while (reading.load(std::memory_order_relaxed)) {
+                    if (::poll(pfds.data(), pfds.size(), 10) <= 0) { continue; }
+                    for (std::size_t i = 0; i != pfds.size(); ++i) {
+                        if (pfds[i].revents & POLLIN) { receive(*owners[i]); }
+                    }
+                }
+            });
+        }
+
+        // All devices share one thread, paced by the earliest scheduled output
+        std::vector<struct pollfd> device_pfds;
+        for (auto& port : ports) {
+            port->device->reset_clock();
+            device_pfds.push_back({ port->device->fd(), POLLIN, 0 });
+        }
+        const auto begin { clock::now() };
+        for (auto now = begin; now - begin < _options.duration; now = clock::now()) {
+            int timeout { 10 };
+            for (auto& port : ports) { timeout = port->device->poll_timeout(now, timeout); }
+            ::poll(device_pfds.data(), device_pfds.size(), timeout);
+            now = clock::now();
+            for (auto& port : ports) { port->device->service(now); }
+        }
+        const double wall { std::chrono::duration<double>(clock::now() - begin).count() };
+
+        // Let readers drain frames still in flight
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        reading.store(false, std::memory_order_relaxed);
+        readers.clear();
+
+        for (auto& port : ports) {
+            port_load_result port_result;
+            port_result.name            = port->device->name();
+            port_result.frames_sent     = port->sent;
+            port_result.frames_received = port->received;
+            port_result.frames_lost     = port->lost;
+            port_result.frames_corrupt  = port->corrupt;
+            port_result.bytes_dropped   = port->device->stats().bytes_dropped;
+            port_result.bytes_per_sec   = static_cast<double>(port->bytes) / wall;
+            port_result.latency         = port->latency.snapshot();
+
+            result.bytes_per_sec   += port_result.bytes_per_sec;
+            result.frames_received += port_result.frames_received;
+            result.frames_lost     += port_result.frames_lost;
+            result.frames_corrupt  += port_result.frames_corrupt;
+            result.bytes_dropped   += port_result.bytes_dropped;
+            result.latency.merge(port_result.latency);
+            result.ports.push_back(std::move(port_result));
+        }
+
+        return result;
+    }
+
+    namespace benchlib::detail {
+        // Keep the compiler from discarding benchmarked results
+        template <typename T>
+        inline void keepValue(const T& _value) noexcept { asm volatile("" : : "r"(&_value) : "memory"); }
+
+        // Repeat a call in doubling batches until the minimum time elapses, returns calls and nanoseconds per call
+        template <typename F>
+        std::pair<uint64_t, double> timeCalls(F&& _call, const std::chrono::nanoseconds _min_time) noexcept {
+            uint64_t   calls { 0 };
+            uint64_t   batch { 1 };
+            const auto begin { std::chrono::steady_clock::now() };
+            while (true) {
+                for (uint64_t i = 0; i != batch; ++i) { _call(); }
+                calls += batch;
+                batch *= 2;
+                const std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - begin };
+                if (elapsed >= _min_time) { return { calls, elapsed.count() / static_cast<double>(calls) }; }
+            }
+        }
+
+        inline std::vector<uint8_t> benchData(const std::size_t _size) noexcept {
+            std::vector<uint8_t> data(_size);
+            uint64_t             state { 0x9e3779b97f4a7c15 };
+            for (auto& byte : data) {
+                state = state * 6364136223846793005 + 1442695040888963407;
+                byte  = static_cast<uint8_t>(state >> 56);
+            }
+            return data;
+        }
+
+        inline constexpr std::array<std::string_view, authlib::detail::crc_types_size> crc_type_names {
+            "crc8", "crc8_cdma2000", "crc8_darc", "crc8_dvb_s2", "crc8_ebu", "crc8_i_code", "crc8_itu", "crc8_maxim", "crc8_rohc", "crc8_wcdma",
+            "crc16_a", "crc16_arc", "crc16_aug_ccitt", "crc16_buypass", "crc16_ccitt_false", "crc16_cdma2000", "crc16_dds_110", "crc16_dect_r",
+            "crc16_dect_x", "crc16_dnp", "crc16_en_13757", "crc16_genibus", "crc16_kermit", "crc16_maxim", "crc16_mcrf4xx", "crc16_modbus",
+            "crc16_riello", "crc16_t10_dif", "crc16_teledisk", "crc16_tms37157", "crc16_usb", "crc16_x_25", "crc16_xmodem",
+            "crc32", "crc32_bzip2", "crc32_c", "crc32_d", "crc32_jamcrc", "crc32_mpeg_2", "crc32_posix", "crc32_q", "crc32_xfer",
+            "crc64_ecma", "crc64_iso"
+        };
+    }
+
+    struct hash_bench_result {
+        std::string_view algorithm;
+        std::string_view kernel;
+        std::size_t      size          { 0 };
+        uint64_t         calls         { 0 };
+        double           ns_per_call   { 0 };
+        double           bytes_per_sec { 0 };
+        bool             verified      { false };
+    };
+
+    /*
+        @brief: Write hash benchmark results as JSON, one object per result, for baseline comparison between runs
+        @param:  _os            - std::ostream &, output stream, e.g. std::ofstream("baseline.json")
+        @param:  _results       - const std::span<const hash_bench_result>, results
+        @return: std::ostream & - output stream
+    */
+    inline std::ostream& bench_json(std::ostream& _os, const std::span<const hash_bench_result> _results) noexcept {
+        const auto flags     { _os.flags() };
+        const auto precision { _os.precision() };
+        _os << std::fixed;
+        _os.precision(3);
+        _os << "{\"results\":[";
+        for (std::size_t i = 0; i != _results.size(); ++i) {
+            const auto& result { _results[i] };
+            _os << (i == 0 ? "\n" : ",\n")
+                << "{\"algorithm\":\"" << result.algorithm << "\",\"kernel\":\"" << result.kernel << "\",\"size\":" << result.size
+                << ",\"calls\":" << result.calls << ",\"ns_per_call\":" << result.ns_per_call << ",\"bytes_per_sec\":" << result.bytes_per_sec
+                << ",\"verified\":" << (result.verified ? "true" : "false") << '}';
+        }
+        _os << "\n]}\n";
+        _os.flags(flags);
+        _os.precision(precision);
+
+        return _os;
+    }
+
+    struct syndrome_bench_options {
+        std::vector<std::size_t>  sizes    { 16, 64, 256, 1024 };
+        std::chrono::milliseconds min_time { 20 };
+    };
+
+    /*
+        @brief: Benchmark single bit error correction with crc_syndrome_table built for each frame size
+                - locate  - syndrome lookup alone
+                - correct - checksum, lookup and in place repair of a frame with one flipped bit, at a different bit each call
+        @param:  _options - const syndrome_bench_options &, frame sizes in bytes and minimum time per measurement
+        @return: std::vector<hash_bench_result> - per call latency, verified if every flipped bit was repaired, write with bench_json()
+    */
+    template <crc_types T, std::enable_if_t<std::is_same_v<decltype(T), crc_types>, bool> = true>
+    std::vector<hash_bench_result> syndrome_bench(const syndrome_bench_options& _options = {}) noexcept {
+        using namespace ubn::benchlib::detail;
+
+        std::vector<hash_bench_result> results;
+        for (const std::size_t size : _options.sizes) {
+            if (size == 0) { continue; }
+            const crc_syndrome_table<T> table(size);
+            auto                        frame    { benchData(size) };
+            const auto                  original { frame };
+            const auto                  crc_code { crc_gen<T>(frame.data(), frame.size()) };
+
+            // Syndromes of every bit position, looked up in turn
+            std::vector<typename crc_syndrome_table<T>::value_type> syndromes;
+            for (std::size_t bit = 0; bit != size * 8; ++bit) {
+                frame[bit / 8] ^= static_cast<uint8_t>(0x01 << bit % 8);
+                syndromes.push_back(static_cast<typename crc_syndrome_table<T>::value_type>(crc_gen<T>(frame.data(), frame.size()) ^ crc_code));
+                frame[bit / 8] ^= static_cast<uint8_t>(0x01 << bit % 8);
+            }
+
+            std::size_t index    { 0 };
+            bool        verified { true };
+            const auto [locate_calls, locate_ns] { timeCalls([&] {
+                keepValue(table.locate(syndromes[index]));
+                index = index + 1 == syndromes.size() ? 0 : index + 1;
+            }, _options.min_time) };
+            results.push_back({ crc_type_names[T], "locate", size, locate_calls, locate_ns, static_cast<double>(size) * 1e9 / locate_ns, true });
+
+            index = 0;
+            const auto [correct_calls, correct_ns] { timeCalls([&] {
+                frame[index / 8] ^= static_cast<uint8_t>(0x01 << index % 8);
+                verified = table.correct(frame, crc_code) && verified;
+                index    = index + 1 == size * 8 ? 0 : index + 1;
+            }, _options.min_time) };
+            verified = verified && frame == original;
+            results.push_back({ crc_type_names[T], "correct", size, correct_calls, correct_ns, static_cast<double>(size) * 1e9 / correct_ns, verified });
+        }
+
+        return results;
+    }
+
+    struct sha256_bench_options {
+        std::vector<std::size_t>  sizes    { 64, 1024, 65536, 1 << 20, 16 << 20 };
+        std::chrono::milliseconds min_time { 20 };
+    };
+
+    /*
+        @brief: Benchmark SHA-256 compression kernels against each other and the dispatching sha256_gen()
+                - portable  - portable block transform
+                - sha_ni    - SHA-NI block transform, only where the CPU supports it
+                - automatic - sha256_gen() including padding, with the kernel selected at runtime
+        @param:  _options - const sha256_bench_options &, input sizes in bytes, rounded down to whole blocks for kernels, and minimum time
+        @return: std::vector<hash_bench_result> - throughput and per call latency, each verified against the FIPS 180-2 "abc" digest,
+                                                  write with bench_json()
+    */
+    inline std::vector<hash_bench_result> sha256_bench(const sha256_bench_options& _options = {}) noexcept {
+        using namespace ubn::benchlib::detail;
+        using namespace ubn::authlib::detail;
+
+        std::vector<std::pair<std::string_view, SHA256Transform>> kernels { { "portable", &transformSHA256 } };
+#if defined(__x86_64__) || defined(__i386__)
+        if (selectSHA256Transform() == &transformSHA256NI) { kernels.emplace_back("sha_ni", &transformSHA256NI); }
+#endif
+
+        // "abc" padded to a single block and its digest as state words
+        std::array<uint8_t, 64> abc_block { 'a', 'b', 'c', 0x80 };
+        abc_block[63] = 24;
+        constexpr std::array<uint32_t, 8> abc_state { 0xba7816bf, 0x8f01cfea, 0x414140de, 0x5dae2223, 0xb00361a3, 0x96177a9c, 0xb410ff61, 0xf20015ad };
+
+        std::vector<hash_bench_result> results;
+        if (_options.sizes.empty()) { return results; }
+        const auto data { benchData(*std::ranges::max_element(_options.sizes)) };
+        for (const std::size_t size : _options.sizes) {
+            const std::size_t blocks { size / 64 };
+            for (const auto& [name, transform] : kernels) {
+                auto state { sha256_init };
+                transform(state.data(), abc_block.data(), 1);
+                const bool verified { state == abc_state };
+                const auto [calls, ns_per_call] { timeCalls([&] {
+                    transform(state.data(), data.data(), blocks);
+                    keepValue(state);
+                }, _options.min_time) };
+                results.push_back({ "sha256", name, blocks * 64, calls, ns_per_call, static_cast<double>(blocks * 64) * 1e9 / ns_per_call, verified });
+            }
+
+            sha256::value_type abc;
+            for (std::size_t i = 0; i != abc.size(); ++i) { abc[i] = static_cast<uint8_t>(abc_state[i / 4] >> (24 - i % 4 * 8)); }
+            const bool verified { sha256_gen(std::string_view("abc")) == abc };
+            const auto [calls, ns_per_call] { timeCalls([&] { keepValue(sha256_gen(data.data(), size)); }, _options.min_time) };
+            results.push_back({ "sha256", "automatic", size, calls, ns_per_call, static_cast<double>(size) * 1e9 / ns_per_call, verified });
+        }
+
+        return results;
+    }
+
+    struct mac_bench_options {
+        std::vector<std::size_t>  sizes    { 16, 64, 256, 1024 };
+        std::size_t               tag_size { 8 };
+        std::chrono::milliseconds min_time { 20 };
+    };
+
+    namespace benchlib::detail {
+        template <typename M>
+        void benchMAC(std::vector<hash_bench_result>& results_, const std::string_view _name, const M& _mac, const mac_bench_options& _options) noexcept {
+            for (const std::size_t size : _options.sizes) {
+                const auto  data { benchData(size) };
+                std::string frame(reinterpret_cast<const char*>(data.data()), size);
+                std::string tagged { frame };
+                bool        verified { mac_append(_mac, tagged, _options.tag_size) && mac_verify(_mac, tagged, _options.tag_size) };
+                tagged.front() ^= 0x01;
+                verified = verified && !mac_verify(_mac, tagged, _options.tag_size);
+                tagged.front() ^= 0x01;
+
+                frame.reserve(size + _options.tag_size);
+                const auto [append_calls, append_ns] { timeCalls([&] {
+                    frame.resize(size);
+                    keepValue(mac_append(_mac, frame, _options.tag_size));
+                }, _options.min_time) };
+                results_.push_back({ _name, "append", size, append_calls, append_ns, static_cast<double>(size) * 1e9 / append_ns, verified });
+
+                const auto [verify_calls, verify_ns] { timeCalls([&] { keepValue(mac_verify(_mac, tagged, _options.tag_size)); }, _options.min_time) };
+                results_.push_back({ _name, "verify", size, verify_calls, verify_ns, static_cast<double>(size) * 1e9 / verify_ns, verified });
+            }
+        }
+    }
+
+    /*
+        @brief: Benchmark per frame cost of SipHash-2-4 and HMAC-SHA256 truncated tags, frames per second is 1e9 / ns_per_call
+                - append - tag computation appended to the frame by mac_append()
+                - verify - constant time check by mac_verify()
+        @param:  _options - const mac_bench_options &, frame payload sizes in bytes, tag size and minimum time per measurement
+        @return: std::vector<hash_bench_result> - per frame latency, verified if a tagged frame verifies and a flipped bit does not,
+                                                  write with bench_json()
+    */
+    inline std::vector<hash_bench_result> mac_bench(const mac_bench_options& _options = {}) noexcept {
+        using namespace ubn::benchlib::detail;
+
+        std::array<uint8_t, 16> key;
+        const auto              key_data { benchData(key.size()) };
+        std::ranges::copy(key_data, key.begin());
+
+        std::vector<hash_bench_result> results;
+        benchMAC(results, "siphash",     siphash(key),     _options);
+        benchMAC(results, "hmac_sha256", hmac_sha256(key), _options);
+
+        return results;
+    }
+
+    struct crc_bench_options {
+        std::vector<std::size_t>  sizes    { 1, 16, 256, 4096, 65536, 1 << 20, 16 << 20, 64 << 20 };
+        std::chrono::milliseconds min_time { 20 };
+    };
+
+    namespace benchlib::detail {
+        template <authlib::detail::CRCTypes T, authlib::detail::CRCKernels K>
+        void benchCRCKernel(std::vector<hash_bench_result>& results_, const crc_bench_options& _options, const std::vector<uint8_t>& _data) noexcept {
+            using namespace ubn::authlib::detail;
+            constexpr std::string_view kernels[] { "automatic", "bytewise", "slicing", "hardware" };
+            constexpr std::string_view check     { "123456789" };
+
+            const bool verified { generateCRCCode<T, K>(reinterpret_cast<const uint8_t*>(check.data()), check.size()) == crc_model<T>.check };
+            for (const std::size_t size : _options.sizes) {
+                const auto [calls, ns_per_call] { timeCalls([&] { keepValue(generateCRCCode<T, K>(_data.data(), size)); }, _options.min_time) };
+                results_.push_back({ crc_type_names[T], kernels[K], size, calls, ns_per_call, static_cast<double>(size) * 1e9 / ns_per_call, verified });
+            }
+        }
+
+        template <authlib::detail::CRCTypes T>
+        void benchCRCType(std::vector<hash_bench_result>& results_, const crc_bench_options& _options, const std::vector<uint8_t>& _data) noexcept {
+            using namespace ubn::authlib::detail;
+            benchCRCKernel<T, CRCKernels::bytewise>(results_, _options, _data);
+            benchCRCKernel<T, CRCKernels::slicing>(results_, _options, _data);
+            if (hasCRCHardware<T>()) { benchCRCKernel<T, CRCKernels::hardware>(results_, _options, _data); }
+        }
+
+        template <std::size_t... I>
+        void benchCRCTypes(std::vector<hash_bench_result>& results_, const crc_bench_options& _options, const std::vector<uint8_t>& _data, std::index_sequence<I...>) noexcept {
+            (benchCRCType<static_cast<authlib::detail::CRCTypes>(I)>(results_, _options, _data), ...);
+        }
+    }
+
+    /*
+        @brief: Benchmark every crc_types with every available kernel (bytewise, slicing, hardware) over the given input sizes
+                Each result is verified against the catalogue check value of "123456789", the defaults run for about half a minute
+        @param:  _options - const crc_bench_options &, input sizes in bytes and minimum time per measurement
+        @return: std::vector<hash_bench_result> - throughput and per call latency, write with bench_json()
+    */
+    inline std::vector<hash_bench_result> crc_bench(const crc_bench_options& _options = {}) noexcept {
+        using namespace ubn::benchlib::detail;
+
+        std::vector<hash_bench_result> results;
+        if (_options.sizes.empty()) { return results; }
+        const auto data { benchData(*std::ranges::max_element(_options.sizes)) };
+        benchCRCTypes(results, _options, data, std::make_index_sequence<authlib::detail::crc_types_size>{});
+
+        return results;
+    }
+}
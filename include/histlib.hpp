@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+namespace ubn {
+    namespace histlib::detail {
+        // Log-linear buckets as HDR histogram, 2^7 linear sub buckets per power of two keeps relative error under 1/64
+        // Values up to 2^40 (about 18 minutes in nanoseconds) are resolved, larger ones land in the last bucket
+        constexpr std::size_t sub_bits     { 7 };
+        constexpr std::size_t value_bits   { 40 };
+        constexpr std::size_t sub_count    { std::size_t { 1 } << sub_bits };
+        constexpr std::size_t sub_half     { sub_count / 2 };
+        constexpr std::size_t buckets_size { sub_count + (value_bits - sub_bits) * sub_half };
+
+        constexpr std::size_t bucketIndex(const uint64_t _value) noexcept {
+            if (_value < sub_count) { return static_cast<std::size_t>(_value); }
+            const std::size_t exponent { static_cast<std::size_t>(std::bit_width(_value)) - sub_bits };
+            const std::size_t index    { sub_count + (exponent - 1) * sub_half + static_cast<std::size_t>(_value >> exponent) - sub_half };
+            return std::min(index, buckets_size - 1);
+        }
+
+        constexpr uint64_t bucketValue(const std::size_t _index) noexcept {
+            if (_index < sub_count) { return _index; }
+            const std::size_t exponent { (_index - sub_count) / sub_half + 1 };
+            return static_cast<uint64_t>((_index - sub_count) % sub_half + sub_half) << exponent;
+        }
+    }
+
+    struct histogram_snapshot {
+        std::vector<uint64_t> counts;
+        uint64_t              total { 0 };
+        uint64_t              sum   { 0 };
+        uint64_t              min   { UINT64_MAX };
+        uint64_t              max   { 0 };
+
+        /*
+            @brief: Get value at percentile
+            @param:  _percentile - const double, percentile in [0, 100]
+            @return: uint64_t    - lower bound of the bucket holding the percentile, 0 if empty
+        */
+        uint64_t percentile(const double _percentile) const noexcept {
+            const auto rank { static_cast<uint64_t>(_percentile / 100.0 * static_cast<double>(total) + 0.5) };
+            uint64_t   seen { 0 };
+            for (std::size_t i = 0; i != counts.size(); ++i) {
+                seen += counts[i];
+                if (seen != 0 && seen >= rank) {
+                    // The last bucket also holds values beyond the resolved range, report the exact max
+                    if (i + 1 == histlib::detail::buckets_size) { return max; }
+                    return std::max(std::min(histlib::detail::bucketValue(i), max), min);
+                }
+            }
+
+            return 0;
+        }
+
+        /*
+            @brief: Get mean value
+            @return: double - mean value, 0 if empty
+        */
+        double mean() const noexcept { return total == 0 ? 0 : static_cast<double>(sum) / static_cast<double>(total); }
+
+        /*
+            @brief: Add counts of another snapshot, e.g. to combine per port histograms
+            @param:  _other - const histogram_snapshot &, snapshot to add
+        */
+        void merge(const histogram_snapshot& _other) noexcept {
+            if (counts.size() < _other.counts.size()) { counts.resize(_other.counts.size()); }
+            for (std::size_t i = 0; i != _other.counts.size(); ++i) { counts[i] += _other.counts[i]; }
+            total += _other.total;
+            sum   += _other.sum;
+            min    = std::min(min, _other.min);
+            max    = std::max(max, _other.max);
+        }
+
+        /*
+            @brief: Operator << for std::ostream, prints HDR style percentile distribution
+            @param: _os             - std::ostream &, output stream
+            @param: _rhs            - const histogram_snapshot &, histogram snapshot
+            @return: std::ostream & - output stream
+        */
+        friend std::ostream& operator<<(std::ostream& _os, const histogram_snapshot& _rhs) noexcept {
+            const auto flags { _os.flags() };
+            _os << std::setw(12) << "Value" << std::setw(12) << "Percentile" << std::setw(12) << "TotalCount" << '\n';
+            for (const double percentile : { 0.0, 50.0, 75.0, 90.0, 99.0, 99.9, 99.99, 100.0 }) {
+                _os << std::setw(12) << _rhs.percentile(percentile)
+                    << std::setw(12) << std::fixed << std::setprecision(4) << percentile / 100.0
+                    << std::setw(12) << static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(_rhs.total) + 0.5) << '\n';
+            }
+            _os << "#[Mean = " << _rhs.mean() << ", Max = " << _rhs.max << ", Total count = " << _rhs.total << "]\n";
+            _os.flags(flags);
+            return _os;
+        }
+    };
+
+    /*
+        @brief: HDR style latency histogram, recording is lock-free and safe to snapshot while recording
+                Buckets (about 17 KB) are allocated on the first record, so unused histograms cost a few words
+    */
+    class histogram {
+    public:
+        /*
+            @brief: Default constructor of histogram, empty
+        */
+        histogram() noexcept = default;
+
+        histogram(const histogram&)            = delete;
+        histogram& operator=(const histogram&) = delete;
+
+        /*
+            @brief: Default destructor of histogram
+        */
+        ~histogram() noexcept { delete[] m_counts.load(std::memory_order_relaxed); }
+
+        /*
+            @brief: Record a value with relaxed atomics, dropped if the first record fails to allocate buckets
+            @param:  _value - const uint64_t, value to record, e.g. nanoseconds
+        */
+        void record(const uint64_t _value) noexcept {
+            auto* counts { m_counts.load(std::memory_order_acquire) };
+            if (counts == nullptr && (counts = allocate()) == nullptr) { return; }
+
+            counts[histlib::detail::bucketIndex(_value)].fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(_value, std::memory_order_relaxed);
+
+            auto min { m_min.load(std::memory_order_relaxed) };
+            while (_value < min && !m_min.compare_exchange_weak(min, _value, std::memory_order_relaxed)) {}
+            auto max { m_max.load(std::memory_order_relaxed) };
+            while (_value > max && !m_max.compare_exchange_weak(max, _value, std::memory_order_relaxed)) {}
+        }
+
+        /*
+            @brief: Copy current counts without stopping recorders, concurrent records may be partially included
+            @return: histogram_snapshot - plain copy of the histogram
+        */
+        histogram_snapshot snapshot() const noexcept {
+            histogram_snapshot snapshot;
+            snapshot.counts.resize(histlib::detail::buckets_size);
+            if (const auto* counts { m_counts.load(std::memory_order_acquire) }; counts != nullptr) {
+                for (std::size_t i = 0; i != snapshot.counts.size(); ++i) {
+                    snapshot.counts[i] = counts[i].load(std::memory_order_relaxed);
+                    snapshot.total    += snapshot.counts[i];
+                }
+            }
+            snapshot.sum = m_sum.load(std::memory_order_relaxed);
+            snapshot.min = m_min.load(std::memory_order_relaxed);
+            snapshot.max = m_max.load(std::memory_order_relaxed);
+
+            return snapshot;
+        }
+
+        /*
+            @brief: Clear all counts
+        */
+        void reset() noexcept {
+            if (auto* counts { m_counts.load(std::memory_order_acquire) }; counts != nullptr) {
+                for (std::size_t i = 0; i != histlib::detail::buckets_size; ++i) { counts[i].store(0, std::memory_order_relaxed); }
+            }
+            m_sum.store(0, std::memory_order_relaxed);
+            m_min.store(UINT64_MAX, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        // Racing first records allocate once, the loser frees its buckets
+        std::atomic<uint64_t>* allocate() noexcept {
+            auto* created  { new (std::nothrow) std::atomic<uint64_t>[histlib::detail::buckets_size] {} };
+            auto* expected { static_cast<std::atomic<uint64_t>*>(nullptr) };
+            if (created == nullptr) { return m_counts.load(std::memory_order_acquire); }
+            if (!m_counts.compare_exchange_strong(expected, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                delete[] created;
+                return expected;
+            }
+            return created;
+        }
+
+        std::atomic<std::atomic<uint64_t>*> m_counts { nullptr };
+        std::atomic<uint64_t>               m_sum    { 0 };
+        std::atomic<uint64_t>               m_min    { UINT64_MAX };
+        std::atomic<uint64_t>               m_max    { 0 };
+    };
+}
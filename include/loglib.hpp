@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+// Messages below this level are compiled out, 0 trace, 1 debug, 2 info, 3 warn, 4 error, 5 off
+#ifndef SERIALIB_LOG_LEVEL
+    #define SERIALIB_LOG_LEVEL 2
+#endif
+
+namespace ubn {
+    namespace loglib::detail {
+        enum LogLevels {
+            trace, debug, info, warn, error, off
+        };
+
+        constexpr std::size_t log_message_size { 240 };
+        constexpr std::size_t log_queue_size   { 1024 };
+
+        struct LogEntry {
+            std::atomic<std::size_t>           sequence { 0 };
+            LogLevels                          level    { info };
+            std::size_t                        size     { 0 };
+            std::array<char, log_message_size> message;
+        };
+
+        // Append one argument to a fixed buffer without allocating, truncating on overflow
+        template <typename T>
+        void appendLog(char* buffer_, std::size_t& size_, const T& _arg) noexcept {
+            if constexpr (std::is_same_v<T, bool>) {
+                appendLog(buffer_, size_, std::string_view(_arg ? "true" : "false"));
+            } else if constexpr (std::is_same_v<T, char>) {
+                if (size_ < log_message_size) { buffer_[size_++] = _arg; }
+            } else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>) {
+                const auto result { std::to_chars(buffer_ + size_, buffer_ + log_message_size, _arg) };
+                size_ = result.ec == std::errc() ? static_cast<std::size_t>(result.ptr - buffer_) : log_message_size;
+            } else {
+                const std::string_view str { _arg };
+                const std::size_t      copy { std::min(str.size(), log_message_size - size_) };
+                std::memcpy(buffer_ + size_, str.data(), copy);
+                size_ += copy;
+            }
+        }
+    }
+
+    using log_levels = loglib::detail::LogLevels;
+
+    constexpr log_levels log_level_min { static_cast<log_levels>(SERIALIB_LOG_LEVEL) };
+
+    /*
+        @brief: Asynchronous logger, producers format into a lock-free bounded queue and never block, a background thread drains it to the sink
+                Messages are dropped and counted when the queue is full
+    */
+    class logger {
+    public:
+        using sink_type = std::function<void(log_levels, std::string_view)>;
+
+        /*
+            @brief: Default constructor of logger, the sink writes lines to std::cout and flushes once per drained batch
+        */
+        logger() noexcept {
+            for (std::size_t i = 0; i != m_entries.size(); ++i) { m_entries[i].sequence.store(i, std::memory_order_relaxed); }
+            m_thread = std::jthread([this](std::stop_token _stop) { drain(_stop); });
+        }
+
+        logger(const logger&)            = delete;
+        logger& operator=(const logger&) = delete;
+
+        /*
+            @brief: Default destructor of logger, writes queued messages before the thread exits
+        */
+        ~logger() noexcept {
+            m_thread.request_stop();
+            wake();
+            m_thread.join();
+        }
+
+        /*
+            @brief: Replace the sink, safe to call while logging, the sink runs on the logger thread only
+            @param:  _sink - sink_type, callback receiving level and message without newline, nullptr discards messages
+        */
+        void set_sink(sink_type _sink) noexcept {
+            const std::lock_guard<std::mutex> sink_gd(sink_lk);
+            m_sink         = std::move(_sink);
+            m_default_sink = false;
+        }
+
+        /*
+            @brief: Make every write wait until the message reaches the sink, used when buffering could lose messages, e.g. at exit
+            @param:  _sync - const bool, whether writes wait for the sink
+        */
+        void set_sync(const bool _sync) noexcept { m_sync.store(_sync, std::memory_order_relaxed); }
+
+        /*
+            @brief: Queue a message, never blocks
+            @param:  _level - const log_levels, message level
+            @param:  _args  - const Args &..., strings, characters and numbers concatenated into the message, truncated at 240 bytes
+            @return: bool   - whether the message is queued, false if dropped
+        */
+        template <typename... Args>
+        bool write(const log_levels _level, const Args&... _args) noexcept {
+            // Bounded MPMC queue by Dmitry Vyukov, each cell sequence tells producers and the consumer whose turn it is
+            std::size_t position { m_tail.load(std::memory_order_relaxed) };
+            loglib::detail::LogEntry* entry { nullptr };
+            while (true) {
+                entry = &m_entries[position % m_entries.size()];
+                const std::size_t sequence { entry->sequence.load(std::memory_order_acquire) };
+                if (sequence == position) {
+                    if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) { break; }
+                } else if (sequence < position) {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                } else {
+                    position = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            entry->level = _level;
+            entry->size  = 0;
+            (loglib::detail::appendLog(entry->message.data(), entry->size, _args), ...);
+            entry->sequence.store(position + 1, std::memory_order_release);
+            wake();
+            if (m_sync.load(std::memory_order_relaxed)) { flush(); }
+
+            return true;
+        }
+
+        /*
+            @brief: Wait until all queued messages are written to the sink
+        */
+        void flush() const noexcept {
+            while (m_written.load(std::memory_order_acquire) != m_tail.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+        }
+
+        /*
+            @brief: Get dropped messages count
+            @return: uint64_t - messages dropped because the queue was full
+        */
+        uint64_t dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        void wake() noexcept {
+            m_signal.fetch_add(1, std::memory_order_release);
+            m_signal.notify_one();
+        }
+
+        void drain(const std::stop_token& _stop) noexcept {
+            std::size_t position { 0 };
+            while (true) {
+                const uint32_t signal { m_signal.load(std::memory_order_acquire) };
+                bool           wrote  { false };
+                for (auto* entry = &m_entries[position % m_entries.size()];
+                     entry->sequence.load(std::memory_order_acquire) == position + 1;
+                     entry = &m_entries[position % m_entries.size()]) {
+                    {
+                        const std::lock_guard<std::mutex> sink_gd(sink_lk);
+                        if (m_sink) { m_sink(entry->level, std::string_view(entry->message.data(), entry->size)); }
+                        wrote = wrote || m_default_sink;
+                    }
+                    entry->sequence.store(position + m_entries.size(), std::memory_order_release);
+                    m_written.store(++position, std::memory_order_release);
+                }
+                // The default sink writes lines without std::endl, flush once per batch instead, custom sinks own their streams
+                if (wrote) { std::cout.flush(); }
+                if (_stop.stop_requested() && m_written.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire)) { return; }
+                m_signal.wait(signal, std::memory_order_acquire);
+            }
+        }
+
+        std::array<loglib::detail::LogEntry, loglib::detail::log_queue_size> m_entries;
+        std::atomic<std::size_t>                                             m_tail    { 0 };
+        std::atomic<std::size_t>                                             m_written { 0 };
+        std::atomic<uint32_t>                                                m_signal  { 0 };
+        std::atomic<uint64_t>                                                m_dropped { 0 };
+        std::atomic<bool>                                                    m_sync    { false };
+        sink_type                                                            m_sink    {
+            [](const log_levels, const std::string_view _message) { std::cout << _message << '\n'; }
+        };
+        bool                                                                 m_default_sink { true };
+        std::jthread                                                         m_thread;
+
+        mutable std::mutex                                                   sink_lk;
+    };
+
+    /*
+        @brief: Get the process wide logger used by serialib, never destroyed so objects with static storage can log from their destructors
+                At exit the queue is flushed and later writes wait for the sink, e.g. close() of a static serialib
+        @return: logger & - logger
+    */
+    inline logger& default_logger() noexcept {
+        static logger* const instance { [] {
+            auto* created { new logger() };
+            std::atexit([] {
+                default_logger().set_sync(true);
+                default_logger().flush();
+            });
+            return created;
+        }() };
+        return *instance;
+    }
+
+    /*
+        @brief: Log a message to the default logger, compiled out below SERIALIB_LOG_LEVEL
+        @param:  _args - const Args &..., strings, characters and numbers concatenated into the message
+    */
+    template <log_levels L, typename... Args>
+    void log_write(const Args&... _args) noexcept {
+        if constexpr (L >= log_level_min && L != log_levels::off) { default_logger().write(L, _args...); }
+    }
+}
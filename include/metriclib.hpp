@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "serialib.hpp"
+
+extern "C" {
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/ioctl.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+}
+
+namespace ubn {
+    namespace metriclib::detail {
+        inline std::string escapeLabel(const std::string_view _value) noexcept {
+            std::string escaped;
+            for (const char c : _value) {
+                if      (c == '\\' || c == '"') { escaped.push_back('\\'); escaped.push_back(c); }
+                else if (c == '\n')             { escaped.append("\\n"); }
+                else                            { escaped.push_back(c); }
+            }
+            return escaped;
+        }
+
+        inline void writeHeader(std::ostream& _os, const std::string_view _name, const std::string_view _type, const std::string_view _help) noexcept {
+            _os << "# HELP " << _name << ' ' << _help << '\n' << "# TYPE " << _name << ' ' << _type << '\n';
+        }
+
+        // HDR histogram as summary, values divided by _scale, e.g. 1e9 for nanoseconds in seconds, quantiles are bucket lower bounds
+        inline void writeSummary(std::ostream& _os, const std::string_view _name, const std::string& _label, const histogram_snapshot& _hist, const double _scale) noexcept {
+            for (const double quantile : { 0.5, 0.9, 0.99, 0.999 }) {
+                _os << _name << '{' << _label << ",quantile=\"" << quantile << "\"} " << static_cast<double>(_hist.percentile(quantile * 100)) / _scale << '\n';
+            }
+            _os << _name << "_sum{"   << _label << "} " << static_cast<double>(_hist.sum) / _scale << '\n';
+            _os << _name << "_count{" << _label << "} " << _hist.total << '\n';
+        }
+    }
+
+    /*
+        @brief: Render counters, queue depths and latency histograms of serial ports in Prometheus text exposition format 0.0.4
+                Queue depths are read with ioctl(2) on native_handle() so scraping does not change the I/O counters
+        @param:  _ports      - std::span<const serialib* const>, ports to export, labelled by device name
+        @return: std::string - exposition text
+    */
+    inline std::string prometheus_text(const std::span<const serialib* const> _ports) noexcept {
+        using namespace ubn::metriclib::detail;
+
+        struct PortMetrics {
+            std::string     label;
+            serial_counters counters;
+            serial_latency  latency;
+            serial_timing   timing;
+            int             input_queue  { 0 };
+            int             output_queue { 0 };
+        };
+
+        std::vector<PortMetrics> ports;
+        for (const serialib* port : _ports) {
+            if (port == nullptr) { continue; }
+            PortMetrics metrics { "port=\"" + escapeLabel(port->device()) + '"', port->counters(), port->latency(), port->timing() };
+            if (port->is_open()) {
+                ::ioctl(port->native_handle(), FIONREAD, &metrics.input_queue);
+                ::ioctl(port->native_handle(), TIOCOUTQ, &metrics.output_queue);
+            }
+            ports.push_back(std::move(metrics));
+        }
+
+        std::ostringstream os;
+        os.precision(12);
+        const auto counter = [&](const std::string_view _name, const std::string_view _help, const auto _field) {
+            writeHeader(os, _name, "counter", _help);
+            for (const auto& port : ports) { os << _name << '{' << port.label << "} " << port.counters.*_field << '\n'; }
+        };
+        const auto kernel_counter = [&](const std::string_view _name, const std::string_view _help, const auto _field) {
+            writeHeader(os, _name, "counter", _help);
+            for (const auto& port : ports) {
+                if (port.counters.kernel_counters) { os << _name << '{' << port.label << "} " << port.counters.*_field << '\n'; }
+            }
+        };
+        const auto gauge = [&](const std::string_view _name, const std::string_view _help, const auto _field) {
+            writeHeader(os, _name, "gauge", _help);
+            for (const auto& port : ports) { os << _name << '{' << port.label << "} " << port.*_field << '\n'; }
+        };
+        const auto summary = [&](const std::string_view _name, const std::string_view _help, const auto _group, const auto _field, const double _scale = 1e9) {
+            writeHeader(os, _name, "summary", _help);
+            for (const auto& port : ports) { writeSummary(os, _name, port.label, port.*_group.*_field, _scale); }
+        };
+
+        counter("serialib_sent_bytes_total",     "Bytes written to the port.",                    &serial_counters::bytes_sent);
+        counter("serialib_received_bytes_total", "Bytes read from the port.",                     &serial_counters::bytes_received);
+        counter("serialib_send_syscalls_total",  "write(2) calls.",                               &serial_counters::send_syscalls);
+        counter("serialib_read_syscalls_total",  "read(2), FIONREAD ioctl(2) and poll(2) calls.", &serial_counters::read_syscalls);
+        counter("serialib_eagain_total",         "Calls returning EAGAIN.",                       &serial_counters::eagain);
+        counter("serialib_send_errors_total",    "Failed write(2) calls.",                        &serial_counters::send_errors);
+        counter("serialib_read_errors_total",    "Failed read(2) calls.",                         &serial_counters::read_errors);
+
+        kernel_counter("serialib_kernel_rx_total",          "Driver received characters.",    &serial_counters::rx);
+        kernel_counter("serialib_kernel_tx_total",          "Driver transmitted characters.", &serial_counters::tx);
+        kernel_counter("serialib_kernel_frame_total",       "Driver framing errors.",         &serial_counters::frame);
+        kernel_counter("serialib_kernel_overrun_total",     "Driver UART overruns.",          &serial_counters::overrun);
+        kernel_counter("serialib_kernel_parity_total",      "Driver parity errors.",          &serial_counters::parity);
+        kernel_counter("serialib_kernel_brk_total",         "Driver break conditions.",       &serial_counters::brk);
+        kernel_counter("serialib_kernel_buf_overrun_total", "Driver buffer overruns.",        &serial_counters::buf_overrun);
+
+        gauge("serialib_input_queue_bytes",  "Bytes waiting in the driver input queue.",  &PortMetrics::input_queue);
+        gauge("serialib_output_queue_bytes", "Bytes waiting in the driver output queue.", &PortMetrics::output_queue);
+
+        summary("serialib_send_duration_seconds",     "Send call duration.",                      &PortMetrics::latency, &serial_latency::send);
+        summary("serialib_read_wakeup_seconds",       "read_wait() wakeup to data read.",         &PortMetrics::latency, &serial_latency::read_wakeup);
+        summary("serialib_delivery_seconds",          "Read syscall to data handed to caller.",   &PortMetrics::latency, &serial_latency::delivery);
+        summary("serialib_transact_duration_seconds", "transact() request to complete response.", &PortMetrics::latency, &serial_latency::transact);
+        summary("serialib_inter_byte_gap_seconds",    "Gap between received chunks.",             &PortMetrics::timing,  &serial_timing::inter_byte);
+        summary("serialib_inter_frame_gap_seconds",   "Gap between read_frame() frame arrivals.", &PortMetrics::timing,  &serial_timing::inter_frame);
+        summary("serialib_read_chunk_bytes",          "Bytes returned per read.",                 &PortMetrics::timing,  &serial_timing::chunk_size, 1);
+
+        return os.str();
+    }
+
+    /*
+        @brief: Render metrics of serial ports in Prometheus text exposition format
+        @param:  _ports      - std::initializer_list<const serialib*>, ports to export
+        @return: std::string - exposition text
+    */
+    inline std::string prometheus_text(const std::initializer_list<const serialib*> _ports) noexcept {
+        return prometheus_text(std::span<const serialib* const>(_ports.begin(), _ports.size()));
+    }
+
+    /*
+        @brief: Tiny HTTP endpoint on 127.0.0.1 answering every request with the provider text, for Prometheus scraping
+    */
+    class metrics_server {
+    public:
+        using provider_type = std::function<std::string()>;
+
+        /*
+            @brief: Bind to localhost and start serving in a background thread
+            @param:  _port     - const uint16_t, TCP port, 0 picks a free port
+            @param:  _provider - provider_type, callback returning the exposition text, e.g. calling prometheus_text()
+        */
+        metrics_server(const uint16_t _port, provider_type _provider) noexcept : m_provider(std::move(_provider)) {
+            m_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (m_fd < 0) { return; }
+
+            const int reuse { 1 };
+            ::setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            struct sockaddr_in addr {};
+            addr.sin_family      = AF_INET;
+            addr.sin_port        = htons(_port);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            socklen_t size { sizeof(addr) };
+            if (::bind(m_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(m_fd, 8) != 0 ||
+                ::getsockname(m_fd, reinterpret_cast<struct sockaddr*>(&addr), &size) != 0) {
+                ::close(m_fd);
+                m_fd = -1;
+                return;
+            }
+            m_port = ntohs(addr.sin_port);
+
+            m_thread = std::jthread([this](std::stop_token _stop) {
+                while (!_stop.stop_requested()) {
+                    struct pollfd pfd { m_fd, POLLIN, 0 };
+                    if (::poll(&pfd, 1, 100) <= 0) { continue; }
+                    const int client { ::accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC) };
+                    if (client < 0) { continue; }
+                    serve(client);
+                    ::close(client);
+                }
+            });
+        }
+
+        metrics_server(const metrics_server&)            = delete;
+        metrics_server& operator=(const metrics_server&) = delete;
+
+        /*
+            @brief: Default destructor of metrics_server, stops serving and closes the socket
+        */
+        ~metrics_server() noexcept {
+            if (m_thread.joinable()) {
+                m_thread.request_stop();
+                m_thread.join();
+            }
+            if (m_fd >= 0) { ::close(m_fd); }
+        }
+
+        /*
+            @brief: Get server status
+            @return: bool - whether the server is listening
+        */
+        bool is_open() const noexcept { return m_fd >= 0; }
+
+        /*
+            @brief: Get bound TCP port
+            @return: uint16_t - port, useful when constructed with 0
+        */
+        uint16_t port() const noexcept { return m_port; }
+
+    private:
+        void serve(const int _client) const noexcept {
+            // One deadline for the whole request, a client trickling bytes or not reading the response cannot hold the endpoint longer
+            const auto deadline { std::chrono::steady_clock::now() + std::chrono::seconds(1) };
+            const auto wait = [&](const short _events) {
+                const auto    remaining { std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()) };
+                struct pollfd pfd       { _client, _events, 0 };
+                return remaining.count() > 0 && ::poll(&pfd, 1, static_cast<int>(remaining.count())) > 0;
+            };
+
+            // Read the request head, the path is ignored
+            std::string request;
+            char        buffer[1024];
+            while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+                if (!wait(POLLIN)) { return; }
+                const auto size { ::read(_client, buffer, sizeof(buffer)) };
+                if (size <= 0) { return; }
+                request.append(buffer, static_cast<std::size_t>(size));
+            }
+
+            const std::string body { m_provider ? m_provider() : std::string() };
+            const std::string response {
+                "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\nContent-Length: " +
+                std::to_string(body.size()) + "\r\n\r\n" + body
+            };
+            for (std::size_t sent = 0; sent < response.size();) {
+                if (!wait(POLLOUT)) { return; }
+                const auto size { ::send(_client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT) };
+                if (size <= 0) { return; }
+                sent += static_cast<std::size_t>(size);
+            }
+        }
+
+        provider_type m_provider;
+        int           m_fd     { -1 };
+        uint16_t      m_port   { 0 };
+        std::jthread  m_thread;
+    };
+}
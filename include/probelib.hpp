@@ -0,0 +1,31 @@
+#pragma once
+
+/*
+    USDT (SystemTap SDT) probe points, a single nop per site with arguments described in the ELF notes, attach without recompiling:
+        bpftrace -e 'usdt:./app:serialib:send { @ns = hist(arg3); }'
+    Probes are compiled in when <sys/sdt.h> is available (systemtap-sdt-dev) and SERIALIB_NO_PROBES is not defined
+
+    Provider serialib:
+        - open(fd, device, device_size, success)
+        - close(fd, device, device_size, success)
+        - send(fd, size, result, duration_ns)
+        - read(fd, result)
+        - frame(fd, payload_size, delivery_ns)
+        - frame_resync(fd, discarded)
+    Provider authlib:
+        - crc_sync_fail(stream_size, payload_size)
+        - mac_fail(frame_size, tag_size)
+    Device names are not NUL terminated, read them with str(arg1, arg2)
+*/
+#if defined(__has_include) && !defined(SERIALIB_NO_PROBES)
+    #if __has_include(<sys/sdt.h>)
+        #include <sys/sdt.h>
+        #define SERIALIB_PROBES 1
+    #endif
+#endif
+
+#ifdef SERIALIB_PROBES
+    #define SERIALIB_PROBE(...) STAP_PROBEV(__VA_ARGS__)
+#else
+    #define SERIALIB_PROBE(...) ((void)0)
+#endif
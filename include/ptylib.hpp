@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+extern "C" {
+    #include <fcntl.h>
+    #include <stdlib.h>
+    #include <unistd.h>
+    #include <termios.h>
+}
+
+namespace ubn {
+    class pty_pair {
+    public:
+        /*
+            @brief: Open a pseudo-terminal pair in raw mode, the slave end is used as serial device
+        */
+        pty_pair() noexcept {
+            m_master = ::posix_openpt(O_RDWR | O_NOCTTY);
+            if (m_master < 0) { return; }
+
+            const char* name { nullptr };
+            if (::grantpt(m_master) != 0 || ::unlockpt(m_master) != 0 || (name = ::ptsname(m_master)) == nullptr) {
+                close();
+                return;
+            }
+            m_name = name;
+
+            // Keep the slave end open so the master never sees hangup while serialib reopens the device
+            m_slave = ::open(m_name.c_str(), O_RDWR | O_NOCTTY);
+            if (m_slave < 0) {
+                close();
+                return;
+            }
+
+            struct termios opt;
+            ::tcgetattr(m_slave, &opt);
+            ::cfmakeraw(&opt);
+            ::tcsetattr(m_slave, TCSANOW, &opt);
+        }
+
+        pty_pair(const pty_pair&)            = delete;
+        pty_pair& operator=(const pty_pair&) = delete;
+
+        /*
+            @brief: Default destructor of pty_pair, closes both ends
+        */
+        ~pty_pair() noexcept { close(); }
+
+        /*
+            @brief: Get pseudo-terminal pair status
+            @return: bool - whether both ends are opened
+        */
+        bool is_open() const noexcept { return m_master >= 0 && m_slave >= 0; }
+
+        /*
+            @brief: Get master end file descriptor, the peer side of the simulated serial device
+            @return: int - file descriptor
+        */
+        int master() const noexcept { return m_master; }
+
+        /*
+            @brief: Get slave end device name, pass to serialib
+            @return: std::string_view - device name, e.g. '/dev/pts/3'
+        */
+        std::string_view name() const noexcept { return m_name; }
+
+        /*
+            @brief: Close both ends
+        */
+        void close() noexcept {
+            if (m_slave  >= 0) { ::close(m_slave);  }
+            if (m_master >= 0) { ::close(m_master); }
+            m_slave  = -1;
+            m_master = -1;
+        }
+
+    private:
+        int         m_master { -1 };
+        int         m_slave  { -1 };
+        std::string m_name;
+    };
+}
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cerrno>
 #include <mutex>
 #include <atomic>
+#include <deque>
 #include <future>
 #include <thread>
 #include <type_traits>
@@ -9,14 +11,114 @@
 #include <string_view>
 #include <iostream>
 
+#include "authlib.hpp"
+#include "histlib.hpp"
+#include "timelib.hpp"
+#include "loglib.hpp"
+#include "probelib.hpp"
+
 extern "C" {
     #include <fcntl.h>
     #include <unistd.h>
+    #include <poll.h>
     #include <termios.h>
     #include <sys/ioctl.h>
+#if defined(__linux__)
+    #include <linux/serial.h>
+#endif
 }
 
 namespace ubn {
+    struct serial_latency {
+        histogram_snapshot send;
+        histogram_snapshot read_wakeup;
+        histogram_snapshot delivery;
+        histogram_snapshot transact;
+    };
+
+    struct serial_chunk {
+        std::string_view data;
+        uint64_t         timestamp  { 0 };
+        uint64_t         first_byte { 0 };
+    };
+
+    struct serial_timing {
+        histogram_snapshot inter_byte;
+        histogram_snapshot inter_frame;
+        histogram_snapshot chunk_size;
+    };
+
+    struct serial_counters {
+        uint64_t bytes_sent     { 0 };
+        uint64_t bytes_received { 0 };
+        uint64_t send_syscalls  { 0 };
+        uint64_t read_syscalls  { 0 };
+        uint64_t eagain         { 0 };
+        uint64_t send_errors    { 0 };
+        uint64_t read_errors    { 0 };
+
+        // Kernel driver counters from TIOCGICOUNT on Linux, zero unless kernel_counters
+        bool     kernel_counters { false };
+        uint64_t rx              { 0 };
+        uint64_t tx              { 0 };
+        uint64_t frame           { 0 };
+        uint64_t overrun         { 0 };
+        uint64_t parity          { 0 };
+        uint64_t brk             { 0 };
+        uint64_t buf_overrun     { 0 };
+    };
+
+    struct serial_snapshot {
+        bool            open            { false };
+
+        // Effective settings read back from the driver by tcgetattr and TIOCMGET, zero unless valid
+        bool            termios_valid   { false };
+        struct termios  termios         {};
+        bool            modem_valid     { false };
+        int             modem_lines     { 0 };
+
+        // Internal buffer fills in bytes, transact_buffer is not sampled while a transact() is waiting
+        std::size_t     read_buffer     { 0 };
+        std::size_t     frame_buffer    { 0 };
+        std::size_t     frame_marks     { 0 };
+        std::size_t     transact_buffer { 0 };
+        bool            transact_active { false };
+
+        uint64_t        pending_sends   { 0 };
+        uint64_t        pending_reads   { 0 };
+
+        // Driver queue depths from FIONREAD and TIOCOUTQ
+        int             input_queue     { 0 };
+        int             output_queue    { 0 };
+
+        serial_counters counters;
+
+        /*
+            @brief: Operator << for std::ostream, one line for watchdog logs
+            @param: _os            - std::ostream &, output stream
+            @param: _rhs           - const serial_snapshot &, snapshot
+            @return: std::ostream & - output stream
+        */
+        friend std::ostream& operator<<(std::ostream& _os, const serial_snapshot& _rhs) noexcept {
+            const auto flags { _os.flags() };
+            _os << "open: " << _rhs.open << std::hex;
+            if (_rhs.termios_valid) {
+                _os << ", iflag: 0x" << _rhs.termios.c_iflag << ", oflag: 0x" << _rhs.termios.c_oflag
+                    << ", cflag: 0x" << _rhs.termios.c_cflag << ", lflag: 0x" << _rhs.termios.c_lflag;
+            }
+            if (_rhs.modem_valid) { _os << ", modem: 0x" << _rhs.modem_lines; }
+            _os << std::dec
+                << ", buffers: "  << _rhs.read_buffer << '/' << _rhs.frame_buffer << '/' << _rhs.frame_marks << '/'
+                                  << _rhs.transact_buffer << (_rhs.transact_active ? " (transact)" : "")
+                << ", pending: "  << _rhs.pending_sends << '/' << _rhs.pending_reads
+                << ", queues: "   << _rhs.input_queue << '/' << _rhs.output_queue
+                << ", bytes: "    << _rhs.counters.bytes_sent << '/' << _rhs.counters.bytes_received
+                << ", errors: "   << _rhs.counters.send_errors << '/' << _rhs.counters.read_errors;
+            _os.flags(flags);
+            return _os;
+        }
+    };
+
     class serialib {
     public:
         /*
@@ -61,6 +163,7 @@ namespace ubn {
             m_fd        = _rhs.m_fd;
             m_opt       = _rhs.m_opt;
             m_sta       = _rhs.m_sta;
+            m_raw_input = _rhs.m_raw_input;
 
             return *this;
         }
@@ -84,10 +187,16 @@ namespace ubn {
             @return: bool  - whether rhs data is sent
         */
         template <typename T, std::enable_if_t<std::is_nothrow_convertible_v<T, std::string_view>, bool> = true>
-        constexpr bool operator<<(const T& _rhs) const noexcept {
-            const std::string_view rhs { _rhs };
+        bool operator<<(const T& _rhs) const noexcept {
+            SERIALIB_TRACE_SPAN("serialib::send");
+            const uint64_t         begin { monotonic_ns() };
+            const std::string_view rhs   { _rhs };
             const std::lock_guard<std::mutex> send_gd(send_lk);
-            return ::write(m_fd, rhs.data(), rhs.size()) > 0;
+            const auto     result   { count_send(::write(m_fd, rhs.data(), rhs.size())) };
+            const uint64_t duration { monotonic_ns() - begin };
+            m_latency.send.record(duration);
+            SERIALIB_PROBE(serialib, send, m_fd, rhs.size(), result, duration);
+            return result > 0;
         }
 
         /*
@@ -97,9 +206,26 @@ namespace ubn {
         std::size_t read_avail() const noexcept {
             std::size_t avail { 0 };
             ::ioctl(m_fd, FIONREAD, &avail);
+            m_counters.read_syscalls.fetch_add(1, std::memory_order_relaxed);
             return avail;
         }
 
+        /*
+            @brief: Wait until data is available to read without spinning
+            @param:  _timeout_ms - const int, timeout in milliseconds, -1 waits forever
+            @return: bool        - whether data is available
+        */
+        bool read_wait(const int _timeout_ms) const noexcept {
+            struct pollfd pfd { m_fd, POLLIN, 0 };
+            const int ready { ::poll(&pfd, 1, _timeout_ms) };
+            m_counters.read_syscalls.fetch_add(1, std::memory_order_relaxed);
+            if (ready <= 0 || !(pfd.revents & POLLIN)) { return false; }
+
+            // Wakeup time is consumed by the next read to measure wakeup to data handed over
+            m_latency.wakeup.store(monotonic_ns(), std::memory_order_relaxed);
+            return true;
+        }
+
         /*
             @brief: Operator std::size_t initlize serialib use as std::size_t
             @return: read_avail
@@ -108,23 +234,328 @@ namespace ubn {
 
         /*
             @brief: Operator >> store received buffer data to rhs_
-            @param:  rhs_  - const std::string_view &, the string_view to store the buffer data
+            @param:  rhs_  - const std::string_view &, the string_view to store the buffer data, valid until next read
             @return: bool  - whether read buffer data is succeeded
         */
         template <typename T, std::enable_if_t<std::is_nothrow_convertible_v<std::string_view, T>, bool> = true>
         bool operator>>(T& rhs_) const noexcept {
+            SERIALIB_TRACE_SPAN("serialib::read");
             const std::lock_guard<std::mutex> read_gd(read_lk);
 
-            void*             p_buffer    { nullptr };
             const std::size_t buffer_size { read_avail() };
-            if (buffer_size > 0 && ::read(m_fd, &p_buffer, buffer_size) > 0) {
-                rhs_ = static_cast<T>(std::string_view(static_cast<char *>(p_buffer), buffer_size));
+            if (buffer_size == 0) { return false; }
+
+            m_read_buffer.resize(buffer_size);
+            const auto     received { count_read(::read(m_fd, m_read_buffer.data(), buffer_size)) };
+            const uint64_t arrival  { monotonic_ns() };
+            SERIALIB_PROBE(serialib, read, m_fd, received);
+            if (received > 0) {
+                rhs_ = static_cast<T>(std::string_view(m_read_buffer.data(), static_cast<std::size_t>(received)));
+                record_chunk(arrival, static_cast<std::size_t>(received));
+                m_latency.delivery.record(monotonic_ns() - arrival);
                 return true;
             }
 
             return false;
         }
 
+        /*
+            @brief: Send a request and read the response up to a delimiter, bytes after the delimiter are kept for the next transact
+                    On timeout or failed send the partial response is discarded, and the next transact discards input queued until then,
+                    so a late response is not paired with the next request unless it arrives after that request is sent
+            @param:  _request    - const std::string_view, request to send
+            @param:  response_   - std::string &, store the response without the delimiter
+            @param:  _delimiter  - const char, response delimiter
+            @param:  _timeout_ms - const int, timeout in milliseconds for the whole response
+            @return: bool        - whether a complete response is read in time
+        */
+        bool transact(const std::string_view _request, std::string& response_, const char _delimiter = '\n', const int _timeout_ms = 1000) const noexcept {
+            SERIALIB_TRACE_SPAN("serialib::transact");
+            const std::lock_guard<std::mutex> transact_gd(transact_lk);
+
+            if (m_transact_stale) {
+                const std::lock_guard<std::mutex> read_gd(read_lk);
+                ::tcflush(m_fd, TCIFLUSH);
+                m_transact_stale = false;
+            }
+
+            const uint64_t begin { monotonic_ns() };
+            if (!(*this << _request)) {
+                m_transact_buffer.clear();
+                return false;
+            }
+
+            const uint64_t deadline { begin + static_cast<uint64_t>(_timeout_ms) * 1000000 };
+            for (std::size_t end; (end = m_transact_buffer.find(_delimiter)) == std::string::npos;) {
+                const uint64_t now { monotonic_ns() };
+                if (now >= deadline || !read_wait(static_cast<int>((deadline - now + 999999) / 1000000))) {
+                    m_transact_buffer.clear();
+                    m_transact_stale = true;
+                    return false;
+                }
+
+                std::string_view chunk;
+                if (*this >> chunk) { m_transact_buffer.append(chunk); }
+            }
+
+            const std::size_t end { m_transact_buffer.find(_delimiter) };
+            response_.assign(m_transact_buffer, 0, end);
+            m_transact_buffer.erase(0, end + 1);
+            m_latency.transact.record(monotonic_ns() - begin);
+
+            return true;
+        }
+
+        /*
+            @brief: Read received data with its arrival time, the timestamp is taken right after the read syscall from the calibrated TSC
+            @param:  chunk_ - serial_chunk &, store data valid until next read, tsc_ns() timestamp after the read and
+                              first byte time estimated by subtracting the line time of all bytes at the configured baudrate and framing
+            @return: bool   - whether read buffer data is succeeded
+        */
+        bool read_timestamped(serial_chunk& chunk_) const noexcept {
+            SERIALIB_TRACE_SPAN("serialib::read");
+            const std::lock_guard<std::mutex> read_gd(read_lk);
+
+            const std::size_t buffer_size { read_avail() };
+            if (buffer_size == 0) { return false; }
+
+            m_read_buffer.resize(buffer_size);
+            const auto     received  { count_read(::read(m_fd, m_read_buffer.data(), buffer_size)) };
+            const uint64_t timestamp { tsc_ns() };
+            SERIALIB_PROBE(serialib, read, m_fd, received);
+            if (received <= 0) { return false; }
+
+            const uint64_t line_ns { line_time(static_cast<std::size_t>(received)) };
+            chunk_.data       = std::string_view(m_read_buffer.data(), static_cast<std::size_t>(received));
+            chunk_.timestamp  = timestamp;
+            chunk_.first_byte = timestamp - std::min(line_ns, timestamp);
+            record_chunk(timestamp, static_cast<std::size_t>(received));
+
+            return true;
+        }
+
+        /*
+            @brief: Get time to transfer bytes on the line at the configured baudrate and character framing
+            @param:  _size    - const std::size_t, bytes
+            @return: uint64_t - nanoseconds
+        */
+        uint64_t line_time(const std::size_t _size) const noexcept {
+            return static_cast<uint64_t>(_size) * char_bits() * 1000000000 / std::max<uint64_t>(bits_per_second(), 1);
+        }
+
+        /*
+            @brief: Read one headerless fixed length frame, locking onto frame boundaries by its trailing CRC code
+                    Requires raw_input(true), default input processing rewrites or drops 0x0d, 0x11 and 0x13 bytes of binary frames
+            @param:  frame_        - std::string &, store the frame payload
+            @param:  _payload_size - const std::size_t, frame payload size in bytes, followed by the CRC code
+            @param:  _crc_order    - const std::endian, byte order of the trailing CRC code, little for reflected CRC by default
+            @return: bool          - whether a frame with matching CRC code is read, always false without raw input
+        */
+        template <crc_types C, std::enable_if_t<std::is_same_v<decltype(C), crc_types>, bool> = true>
+        bool read_frame(
+            std::string&      frame_,
+            const std::size_t _payload_size,
+            const std::endian _crc_order = authlib::detail::crc_model<C>.ref_out ? std::endian::little : std::endian::big
+        ) const noexcept {
+            SERIALIB_TRACE_SPAN("serialib::read_frame");
+            const std::lock_guard<std::mutex> read_gd(read_lk);
+            if (m_raw_input == false) { return false; }
+
+            // Append received data to unconsumed bytes kept from last call, marking when each chunk arrived
+            const std::size_t buffer_size { read_avail() };
+            if (buffer_size > 0) {
+                SERIALIB_TRACE_SPAN("serialib::read");
+                const std::size_t offset { m_frame_buffer.size() };
+                m_frame_buffer.resize(offset + buffer_size);
+                const auto received { count_read(::read(m_fd, m_frame_buffer.data() + offset, buffer_size)) };
+                SERIALIB_PROBE(serialib, read, m_fd, received);
+                m_frame_buffer.resize(offset + (received > 0 ? received : 0));
+                if (received > 0) {
+                    m_frame_arrivals.emplace_back(m_frame_buffer.size(), monotonic_ns());
+                    record_chunk(m_frame_arrivals.back().second, static_cast<std::size_t>(received));
+                }
+            }
+
+            const std::size_t frame_size { _payload_size + sizeof(authlib::detail::CRCValue<C>) };
+            const std::size_t offset     { crc_frame_sync<C>(
+                std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(m_frame_buffer.data()), m_frame_buffer.size()), _payload_size, _crc_order
+            ) };
+            if (offset == SIZE_MAX) {
+                // Keep the tail that may still be the head of a frame
+                if (m_frame_buffer.size() >= frame_size) {
+                    SERIALIB_PROBE(serialib, frame_resync, m_fd, m_frame_buffer.size() - frame_size + 1);
+                    erase_frame_buffer(m_frame_buffer.size() - frame_size + 1);
+                }
+                return false;
+            }
+
+            // First byte of the frame arrived with the first chunk ending after it
+            const auto arrival { std::ranges::find_if(m_frame_arrivals, [offset](const auto& _mark) { return _mark.first > offset; }) };
+            const uint64_t delivery { arrival != m_frame_arrivals.end() ? monotonic_ns() - arrival->second : 0 };
+            if (arrival != m_frame_arrivals.end()) {
+                m_latency.delivery.record(delivery);
+                if (m_timing.enabled.load(std::memory_order_relaxed)) {
+                    if (m_timing.last_frame != 0) { m_timing.inter_frame.record(arrival->second - m_timing.last_frame); }
+                    m_timing.last_frame = arrival->second;
+                }
+            }
+            if (offset != 0) { SERIALIB_PROBE(serialib, frame_resync, m_fd, offset); }
+            SERIALIB_PROBE(serialib, frame, m_fd, _payload_size, delivery);
+
+            frame_.assign(m_frame_buffer, offset, _payload_size);
+            erase_frame_buffer(offset + frame_size);
+
+            return true;
+        }
+
+        /*
+            @brief: Get latency histograms in nanoseconds without stopping I/O
+                    - send        - operator << call duration
+                    - read_wakeup - read_wait() wakeup to data read by the next operator >> or read_frame()
+                    - delivery    - read syscall return to data handed to caller, includes deframing wait in read_frame()
+                    - transact    - transact() request send to complete response
+            @return: serial_latency - histograms snapshot
+        */
+        serial_latency latency() const noexcept {
+            return { m_latency.send.snapshot(), m_latency.read_wakeup.snapshot(), m_latency.delivery.snapshot(), m_latency.transact.snapshot() };
+        }
+
+        /*
+            @brief: Get I/O counters without stopping I/O, kernel driver counters are merged in by TIOCGICOUNT where the driver supports it
+                    - read_syscalls counts read(2), FIONREAD ioctl(2) and poll(2) issued by serialib
+            @return: serial_counters - counters snapshot
+        */
+        serial_counters counters() const noexcept {
+            serial_counters counters;
+            counters.bytes_sent     = m_counters.bytes_sent.load(std::memory_order_relaxed);
+            counters.bytes_received = m_counters.bytes_received.load(std::memory_order_relaxed);
+            counters.send_syscalls  = m_counters.send_syscalls.load(std::memory_order_relaxed);
+            counters.read_syscalls  = m_counters.read_syscalls.load(std::memory_order_relaxed);
+            counters.eagain         = m_counters.eagain.load(std::memory_order_relaxed);
+            counters.send_errors    = m_counters.send_errors.load(std::memory_order_relaxed);
+            counters.read_errors    = m_counters.read_errors.load(std::memory_order_relaxed);
+
+#ifdef TIOCGICOUNT
+            struct serial_icounter_struct icount {};
+            if (is_open() && ::ioctl(m_fd, TIOCGICOUNT, &icount) == 0) {
+                counters.kernel_counters = true;
+                counters.rx              = static_cast<uint64_t>(icount.rx);
+                counters.tx              = static_cast<uint64_t>(icount.tx);
+                counters.frame           = static_cast<uint64_t>(icount.frame);
+                counters.overrun         = static_cast<uint64_t>(icount.overrun);
+                counters.parity          = static_cast<uint64_t>(icount.parity);
+                counters.brk             = static_cast<uint64_t>(icount.brk);
+                counters.buf_overrun     = static_cast<uint64_t>(icount.buf_overrun);
+            }
+#endif
+
+            return counters;
+        }
+
+        /*
+            @brief: Get port internals in one snapshot, cheap enough for a watchdog thread calling every second
+                    Driver state is read with ioctl(2) and tcgetattr(3), buffers under a brief read lock, counters as in counters()
+            @return: serial_snapshot - effective termios and modem lines, buffer fills, pending async operations, queue depths and counters
+        */
+        serial_snapshot debug_snapshot() const noexcept {
+            serial_snapshot snapshot;
+            snapshot.open = is_open();
+            if (snapshot.open) {
+                snapshot.termios_valid = ::tcgetattr(m_fd, &snapshot.termios) == 0;
+                snapshot.modem_valid   = ::ioctl(m_fd, TIOCMGET, &snapshot.modem_lines) == 0;
+                ::ioctl(m_fd, FIONREAD, &snapshot.input_queue);
+                ::ioctl(m_fd, TIOCOUTQ, &snapshot.output_queue);
+            }
+
+            {
+                const std::lock_guard<std::mutex> read_gd(read_lk);
+                snapshot.read_buffer  = m_read_buffer.size();
+                snapshot.frame_buffer = m_frame_buffer.size();
+                snapshot.frame_marks  = m_frame_arrivals.size();
+            }
+            // transact() holds its lock while waiting for the response, never block the watchdog on it
+            if (std::unique_lock<std::mutex> transact_gd(transact_lk, std::try_to_lock); transact_gd.owns_lock()) {
+                snapshot.transact_buffer = m_transact_buffer.size();
+            } else {
+                snapshot.transact_active = true;
+            }
+
+            snapshot.pending_sends = m_pending.sends.load(std::memory_order_relaxed);
+            snapshot.pending_reads = m_pending.reads.load(std::memory_order_relaxed);
+            snapshot.counters      = counters();
+
+            return snapshot;
+        }
+
+        /*
+            @brief: Enable or disable raw input, off by default, input maps CR to NL and consumes XON / XOFF for software flow control
+                    Binary data such as read_frame() frames needs raw input, text protocols may keep the default
+            @param:  _enabled - const bool, whether INPCK, ICRNL, IXON and IXOFF are cleared, kept when the port is reopened
+            @return: bool     - whether the serial port options are applied, true if the port is not opened yet
+        */
+        bool raw_input(const bool _enabled) noexcept {
+            const std::lock_guard<std::mutex> read_gd(read_lk);
+            m_raw_input = _enabled;
+            if (is_open() == false) { return true; }
+
+            if (_enabled) { m_opt.c_iflag &= ~(INPCK | ICRNL | IXON | IXOFF); }
+            else          { m_opt.c_iflag |=   INPCK | ICRNL | IXON | IXOFF;  }
+            return ::tcsetattr(m_fd, TCSANOW, &m_opt) == 0;
+        }
+
+        /*
+            @brief: Enable or disable receive timing analysis, off by default, costs one relaxed load per read when off
+            @param:  _enabled - const bool, whether received chunks are timestamped into timing histograms
+        */
+        void timing_enable(const bool _enabled) const noexcept {
+            const std::lock_guard<std::mutex> read_gd(read_lk);
+            m_timing.enabled.store(_enabled, std::memory_order_relaxed);
+            m_timing.last_chunk = 0;
+            m_timing.last_frame = 0;
+        }
+
+        /*
+            @brief: Get receive timing histograms without stopping I/O, e.g. USB adapter latency timers show as inter_byte clusters
+                    - inter_byte  - nanoseconds between consecutive received chunks, the gaps before each chunk's first byte
+                    - inter_frame - nanoseconds between first byte arrivals of consecutive read_frame() frames
+                    - chunk_size  - bytes returned per read
+            @return: serial_timing - histograms snapshot
+        */
+        serial_timing timing() const noexcept {
+            return { m_timing.inter_byte.snapshot(), m_timing.inter_frame.snapshot(), m_timing.chunk_size.snapshot() };
+        }
+
+        /*
+            @brief: Clear timing histograms
+        */
+        void timing_reset() const noexcept {
+            m_timing.inter_byte.reset();
+            m_timing.inter_frame.reset();
+            m_timing.chunk_size.reset();
+        }
+
+        /*
+            @brief: Clear latency histograms
+        */
+        void latency_reset() const noexcept {
+            m_latency.send.reset();
+            m_latency.read_wakeup.reset();
+            m_latency.delivery.reset();
+            m_latency.transact.reset();
+        }
+
+        /*
+            @brief: Get device name of serial port
+            @return: std::string_view - device name
+        */
+        constexpr std::string_view device() const noexcept { return m_device; }
+
+        /*
+            @brief: Get file descriptor of serial port, e.g. to multiplex many ports with poll(2)
+            @return: int - file descriptor, only valid while is_open()
+        */
+        constexpr int native_handle() const noexcept { return m_fd; }
+
         /*
             @brief: Get current serial port status
             @return: bool - whether serial port is opend
@@ -140,7 +571,7 @@ namespace ubn {
         template <typename T, std::enable_if_t<std::is_nothrow_convertible_v<T, std::string_view>, bool> = true>
         bool open(const T& _dev, const std::size_t& _baud) noexcept {
             if (is_open() != false) {
-                std::cout << "serialib -> " << m_fd << ", serial'" << _dev << "' already opened" << std::endl;
+                log_write<log_levels::warn>("serialib -> ", m_fd, ", serial '", std::string_view(_dev), "' already opened");
                 return true;
             }
 
@@ -157,7 +588,8 @@ namespace ubn {
             */
             m_fd = ::open(m_device.data(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_ASYNC);
             if (m_fd <= 0) {
-                std::cout << "serialib -> " << m_fd << ", open '" << m_device << "' failed" << std::endl;
+                log_write<log_levels::error>("serialib -> ", m_fd, ", open '", m_device, "' failed");
+                SERIALIB_PROBE(serialib, open, m_fd, m_device.data(), m_device.size(), false);
                 return false;
             }
 
@@ -189,11 +621,13 @@ namespace ubn {
                 - IXON      enable output flow control
                 - IXOFF     enable input flow control
                 - IUTF8     maintain state for UTF-8 VERASE
+            Software input processing is skipped with raw_input(true)
             */
             m_opt.c_cc[VTIME] = 0;
             m_opt.c_cc[VMIN]  = 0;
             m_opt.c_cflag    |= CS8   | CREAD | CLOCAL;
-            m_opt.c_iflag    |= INPCK | ICRNL | IXON | IXOFF | IUTF8;
+            m_opt.c_iflag    |= IUTF8;
+            if (m_raw_input == false) { m_opt.c_iflag |= INPCK | ICRNL | IXON | IXOFF; }
 
             // Set serial port options
             ::tcsetattr(m_fd, TCSANOW, &m_opt);
@@ -212,7 +646,9 @@ namespace ubn {
             ::ioctl(m_fd, TIOCMSET, &m_sta);
 
             flush();
-            std::cout << "serialib -> " << m_fd << ", open '" << m_device << "' success" << std::endl;
+            tsc_calibrate();
+            log_write<log_levels::info>("serialib -> ", m_fd, ", open '", m_device, "' success");
+            SERIALIB_PROBE(serialib, open, m_fd, m_device.data(), m_device.size(), true);
 
             return true;
         }
@@ -223,16 +659,18 @@ namespace ubn {
         */
         bool close() noexcept {
             if (is_open() == false) {
-                std::cout << "serialib -> " << m_fd << ", serial '" << m_device << "' not opened" << std::endl;
+                log_write<log_levels::warn>("serialib -> ", m_fd, ", serial '", m_device, "' not opened");
                 return true;
             }
 
+            [[maybe_unused]] const int fd { m_fd };
             m_fd = ::close(m_fd);
+            SERIALIB_PROBE(serialib, close, fd, m_device.data(), m_device.size(), m_fd == 0);
             if (m_fd != 0) {
-                std::cout << "serialib -> " << m_fd << ", close '" << m_device << "' failed" << std::endl;
+                log_write<log_levels::error>("serialib -> ", m_fd, ", close '", m_device, "' failed");
                 return false;
             } else {
-                std::cout << "serialib -> " << m_fd << ", close '" << m_device << "' success" << std::endl;
+                log_write<log_levels::info>("serialib -> ", m_fd, ", close '", m_device, "' success");
                 return true;
             }
         }
@@ -250,16 +688,19 @@ namespace ubn {
 
         /*
             @brief: Async send data
-            @param:  _data_ftr          - const std::future<std::string_view> &, data to send
+            @param:  _data_ftr          - std::future<std::string_view>, data to send, moved into the send thread
             @return: std::future<bool>  - send status future
         */
         template <typename T, std::enable_if_t<std::is_nothrow_convertible_v<T, std::string_view>, bool> = true>
-        std::future<bool> async_send(const std::future<T>& _data_ftr) const noexcept {
+        std::future<bool> async_send(std::future<T> _data_ftr) const noexcept {
             std::promise<bool> pms;
             std::future<bool>  ftr { pms.get_future() };
 
-            std::thread thr([_this = this, _pms = std::move(pms), __data_ftr = &_data_ftr]() mutable {
-                _pms.set_value(*_this << __data_ftr.get());
+            m_pending.sends.fetch_add(1, std::memory_order_relaxed);
+            std::thread thr([_this = this, _pms = std::move(pms), __data_ftr = std::move(_data_ftr)]() mutable {
+                const bool sent { *_this << __data_ftr.get() };
+                _this->m_pending.sends.fetch_sub(1, std::memory_order_relaxed);
+                _pms.set_value(sent);
             });
             thr.detach();
 
@@ -275,11 +716,13 @@ namespace ubn {
             std::promise<T> pms;
             std::future<T>  ftr { pms.get_future() };
 
-            std::thread thr([_this = this, _pms = std::move(pms)]() {
+            m_pending.reads.fetch_add(1, std::memory_order_relaxed);
+            std::thread thr([_this = this, _pms = std::move(pms)]() mutable {
                 T buffer;
                 while (!(*_this >> buffer)) {
                     std::this_thread::yield();
                 }
+                _this->m_pending.reads.fetch_sub(1, std::memory_order_relaxed);
                 _pms.set_value(buffer);
             });
             thr.detach();
@@ -292,9 +735,9 @@ namespace ubn {
         */
         void terminal() const noexcept {
             if (is_open()) {
-                std::cout << "serialib -> " << m_fd << ", running terminal on '" << m_device << "', enter 'exit' to leave" << std::endl;
+                log_write<log_levels::info>("serialib -> ", m_fd, ", running terminal on '", m_device, "', enter 'exit' to leave");
             } else {
-                std::cout << "serialib -> " << m_fd << ", serial '" << m_device << "' not opened" << std::endl;
+                log_write<log_levels::warn>("serialib -> ", m_fd, ", serial '", m_device, "' not opened");
                 return;
             }
 
@@ -304,7 +747,7 @@ namespace ubn {
 
             // Create read thread, capture all varibles pointer, read from the serial
             std::jthread thr([_this = this, _exit = &exit]() mutable {
-                while (!_exit) {
+                while (!_exit->test()) {
                     std::cout << *_this;
                     std::this_thread::yield();
                 }
@@ -321,16 +764,119 @@ namespace ubn {
         }
 
     protected:
+        // Line rate in bits per second, accepts both termios speed constants and plain numbers, BSD speed constants are plain numbers
+        uint64_t bits_per_second() const noexcept {
+#if defined(__linux__)
+            constexpr std::pair<speed_t, uint64_t> speeds[] {
+                { B50,     50     }, { B75,     75     }, { B110,    110    }, { B134,    134    }, { B150,    150    },
+                { B200,    200    }, { B300,    300    }, { B600,    600    }, { B1200,   1200   }, { B1800,   1800   },
+                { B2400,   2400   }, { B4800,   4800   }, { B9600,   9600   }, { B19200,  19200  }, { B38400,  38400  },
+                { B57600,  57600  }, { B115200, 115200 }, { B230400, 230400 }, { B460800, 460800 }, { B500000, 500000 },
+                { B576000, 576000 }, { B921600, 921600 }, { B1000000, 1000000 }, { B1152000, 1152000 }, { B1500000, 1500000 },
+                { B2000000, 2000000 }, { B2500000, 2500000 }, { B3000000, 3000000 }, { B3500000, 3500000 }, { B4000000, 4000000 }
+            };
+            for (const auto& [speed, bits] : speeds) {
+                if (speed == m_baudrates) { return bits; }
+            }
+#endif
+            return m_baudrates;
+        }
+
+        // Bits on the line per character, start bit, data bits, parity bit and stop bits
+        uint64_t char_bits() const noexcept {
+            const tcflag_t size { m_opt.c_cflag & CSIZE };
+            const uint64_t data { size == CS5 ? 5u : size == CS6 ? 6u : size == CS7 ? 7u : 8u };
+            return 1 + data + ((m_opt.c_cflag & PARENB) ? 1 : 0) + ((m_opt.c_cflag & CSTOPB) ? 2 : 1);
+        }
+
+        ssize_t count_send(const ssize_t _sent) const noexcept {
+            m_counters.send_syscalls.fetch_add(1, std::memory_order_relaxed);
+            if (_sent >= 0) { m_counters.bytes_sent.fetch_add(static_cast<uint64_t>(_sent), std::memory_order_relaxed); }
+            else            { (errno == EAGAIN ? m_counters.eagain : m_counters.send_errors).fetch_add(1, std::memory_order_relaxed); }
+            return _sent;
+        }
+
+        ssize_t count_read(const ssize_t _received) const noexcept {
+            m_counters.read_syscalls.fetch_add(1, std::memory_order_relaxed);
+            if (_received >= 0) { m_counters.bytes_received.fetch_add(static_cast<uint64_t>(_received), std::memory_order_relaxed); }
+            else                { (errno == EAGAIN ? m_counters.eagain : m_counters.read_errors).fetch_add(1, std::memory_order_relaxed); }
+            return _received;
+        }
+
+        void record_chunk(const uint64_t _arrival, const std::size_t _size) const noexcept {
+            if (const uint64_t wakeup { m_latency.wakeup.exchange(0, std::memory_order_relaxed) }; wakeup != 0) {
+                m_latency.read_wakeup.record(_arrival - wakeup);
+            }
+            if (m_timing.enabled.load(std::memory_order_relaxed)) {
+                if (m_timing.last_chunk != 0) { m_timing.inter_byte.record(_arrival - m_timing.last_chunk); }
+                m_timing.last_chunk = _arrival;
+                m_timing.chunk_size.record(_size);
+            }
+        }
+
+        void erase_frame_buffer(const std::size_t _size) const noexcept {
+            m_frame_buffer.erase(0, _size);
+            while (!m_frame_arrivals.empty() && m_frame_arrivals.front().first <= _size) { m_frame_arrivals.pop_front(); }
+            for (auto& mark : m_frame_arrivals) { mark.first -= _size; }
+        }
+
+        struct SerialLatency {
+            histogram             send;
+            histogram             read_wakeup;
+            histogram             delivery;
+            histogram             transact;
+            std::atomic<uint64_t> wakeup { 0 };
+        };
+
+        // Last arrival times are guarded by read_lk
+        struct SerialTiming {
+            std::atomic<bool> enabled     { false };
+            histogram         inter_byte;
+            histogram         inter_frame;
+            histogram         chunk_size;
+            uint64_t          last_chunk  { 0 };
+            uint64_t          last_frame  { 0 };
+        };
+
+        struct SerialCounters {
+            std::atomic<uint64_t> bytes_sent     { 0 };
+            std::atomic<uint64_t> bytes_received { 0 };
+            std::atomic<uint64_t> send_syscalls  { 0 };
+            std::atomic<uint64_t> read_syscalls  { 0 };
+            std::atomic<uint64_t> eagain         { 0 };
+            std::atomic<uint64_t> send_errors    { 0 };
+            std::atomic<uint64_t> read_errors    { 0 };
+        };
+
+        // async_send() and async_read() threads not finished yet
+        struct SerialPending {
+            std::atomic<uint64_t> sends { 0 };
+            std::atomic<uint64_t> reads { 0 };
+        };
+
         std::string_view             m_device;
         std::size_t                  m_baudrates;
 
         int                          m_fd        { -1 };
         int                          m_sta       { -1 };
         struct  termios              m_opt;
+        bool                         m_raw_input { false };
+
+        mutable std::string          m_read_buffer;
+        mutable std::string          m_frame_buffer;
+        mutable std::string          m_transact_buffer;
+        mutable bool                 m_transact_stale { false };
+
+        mutable std::deque<std::pair<std::size_t, uint64_t>> m_frame_arrivals;
+        mutable SerialLatency                                m_latency;
+        mutable SerialCounters                               m_counters;
+        mutable SerialTiming                                 m_timing;
+        mutable SerialPending                                m_pending;
 
     private:
         mutable std::mutex           send_lk;
         mutable std::mutex           read_lk;
         mutable std::mutex           term_lk;
+        mutable std::mutex           transact_lk;
     };
 }
@@ -0,0 +1,508 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <random>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ptylib.hpp"
+
+extern "C" {
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <termios.h>
+}
+
+namespace ubn {
+    namespace simlib::detail {
+        using clock = std::chrono::steady_clock;
+
+        enum LinkDirections {
+            to_device, to_host
+        };
+
+        // Flip each bit independently with the given probability, geometric skips keep low error rates cheap
+        inline std::size_t flipBits(std::string& data_, const double _bit_error_rate, std::mt19937_64& _engine) noexcept {
+            if (_bit_error_rate <= 0 || data_.empty()) { return 0; }
+            const uint64_t bits { static_cast<uint64_t>(data_.size()) * 8 };
+            if (_bit_error_rate >= 1) {
+                for (auto& byte : data_) { byte = static_cast<char>(~byte); }
+                return static_cast<std::size_t>(bits);
+            }
+
+            std::geometric_distribution<uint64_t> skip(_bit_error_rate);
+            std::size_t                           flipped { 0 };
+            for (uint64_t bit = skip(_engine); bit < bits; bit += skip(_engine) + 1) {
+                data_[bit / 8] = static_cast<char>(data_[bit / 8] ^ (1 << (bit % 8)));
+                ++flipped;
+            }
+
+            return flipped;
+        }
+    }
+
+    using link_directions = simlib::detail::LinkDirections;
+
+    struct sim_stats {
+        uint64_t bytes_in      { 0 };
+        uint64_t bytes_out     { 0 };
+        uint64_t bytes_dropped { 0 };
+        uint64_t bits_flipped  { 0 };
+        uint64_t requests      { 0 };
+        uint64_t responses     { 0 };
+    };
+
+    /*
+        @brief: Simulated serial device on a pseudo-terminal pair, open name() with serialib and the device answers on the master end
+                Behavior is scripted with on() rules, a callback, a constant rate stream and bit error injection, configure before start()
+    */
+    class sim_device {
+    public:
+        using clock          = simlib::detail::clock;
+        using handler_type   = std::function<std::string(std::string_view)>;
+        using generator_type = std::function<std::string()>;
+
+        /*
+            @brief: Default constructor of sim_device, the master end is non-blocking so a host that stops reading drops output like a real UART
+            @param:  _delimiter - const char, request delimiter, requests are matched line by line
+        */
+        explicit sim_device(const char _delimiter = '\n') noexcept : m_delimiter(_delimiter) {
+            if (m_pty.is_open()) { ::fcntl(m_pty.master(), F_SETFL, ::fcntl(m_pty.master(), F_GETFL) | O_NONBLOCK); }
+        }
+
+        sim_device(const sim_device&)            = delete;
+        sim_device& operator=(const sim_device&) = delete;
+
+        /*
+            @brief: Default destructor of sim_device, stops the device thread
+        */
+        ~sim_device() noexcept { stop(); }
+
+        /*
+            @brief: Get simulated device status
+            @return: bool - whether the pseudo-terminal pair is opened
+        */
+        bool is_open() const noexcept { return m_pty.is_open(); }
+
+        /*
+            @brief: Get device name, pass to serialib
+            @return: std::string_view - device name, e.g. '/dev/pts/3'
+        */
+        std::string_view name() const noexcept { return m_pty.name(); }
+
+        /*
+            @brief: Get master end file descriptor, for custom event loops driving service()
+            @return: int - file descriptor
+        */
+        int fd() const noexcept { return m_pty.master(); }
+
+        /*
+            @brief: Add a scripted response, matched against each request without the delimiter
+            @param:  _request  - std::string, exact request to match
+            @param:  _response - std::string, response to send
+            @param:  _latency  - const std::chrono::microseconds, delay before the response is sent
+        */
+        void on(std::string _request, std::string _response, const std::chrono::microseconds _latency = {}) noexcept {
+            m_rules.emplace_back(std::move(_request), std::move(_response), _latency);
+        }
+
+        /*
+            @brief: Set callback for requests without a scripted rule, an empty return sends nothing
+            @param:  _handler  - handler_type, callback receiving the request without the delimiter and returning the response
+            @param:  _latency  - const std::chrono::microseconds, delay before the response is sent
+        */
+        void on(handler_type _handler, const std::chrono::microseconds _latency = {}) noexcept {
+            m_handler         = std::move(_handler);
+            m_handler_latency = _latency;
+        }
+
+        /*
+            @brief: Stream data continuously at a constant rate, the data repeats
+            @param:  _data           - std::string, data to stream, e.g. a frame
+            @param:  _bytes_per_sec  - const double, stream rate, 0 disables streaming
+        */
+        void stream(std::string _data, const double _bytes_per_sec) noexcept {
+            m_stream           = std::move(_data);
+            m_stream_generator = nullptr;
+            m_stream_rate      = _bytes_per_sec;
+        }
+
+        /*
+            @brief: Stream generated frames continuously at a constant rate, the generator is called when the first byte of the next frame is due
+            @param:  _generator      - generator_type, callback returning the next frame, e.g. stamped with sequence and time
+            @param:  _bytes_per_sec  - const double, stream rate, 0 disables streaming
+        */
+        void stream(generator_type _generator, const double _bytes_per_sec) noexcept {
+            m_stream.clear();
+            m_stream_generator = std::move(_generator);
+            m_stream_rate      = _bytes_per_sec;
+        }
+
+        /*
+            @brief: Inject independent bit errors into all output
+            @param:  _bit_error_rate - const double, probability of each bit to flip
+            @param:  _seed           - const uint64_t, random seed for reproducible errors
+        */
+        void inject(const double _bit_error_rate, const uint64_t _seed = 0) noexcept {
+            m_bit_error_rate = _bit_error_rate;
+            m_engine.seed(_seed);
+        }
+
+        /*
+            @brief: Start the device thread
+            @return: bool - whether the device is started
+        */
+        bool start() noexcept {
+            if (!is_open() || m_thread.joinable()) { return false; }
+            reset_clock();
+            m_thread = std::jthread([this](std::stop_token _stop) {
+                while (!_stop.stop_requested()) {
+                    struct pollfd pfd { fd(), POLLIN, 0 };
+                    ::poll(&pfd, 1, poll_timeout(clock::now(), 10));
+                    service(clock::now());
+                }
+            });
+
+            return true;
+        }
+
+        /*
+            @brief: Stop the device thread
+        */
+        void stop() noexcept {
+            if (!m_thread.joinable()) { return; }
+            m_thread.request_stop();
+            m_thread.join();
+        }
+
+        /*
+            @brief: Restart stream pacing from now, call before driving service() from a custom event loop
+        */
+        void reset_clock() noexcept {
+            m_stream_begin   = clock::now();
+            m_stream_emitted = 0;
+            m_stream_offset  = 0;
+            if (m_stream_generator) { m_stream.clear(); }
+        }
+
+        /*
+            @brief: Get poll(2) timeout until the next scheduled output
+            @param:  _now        - const clock::time_point, current time
+            @param:  _max_ms     - const int, upper bound in milliseconds
+            @return: int         - timeout in milliseconds
+        */
+        int poll_timeout(const clock::time_point _now, const int _max_ms) const noexcept {
+            if (streaming()) { return std::min(_max_ms, 1); }
+            if (m_pending.empty()) { return _max_ms; }
+            const auto wait { std::chrono::ceil<std::chrono::milliseconds>(m_pending.begin()->first - _now).count() };
+            return static_cast<int>(std::clamp<int64_t>(wait, 0, _max_ms));
+        }
+
+        /*
+            @brief: Handle pending input and due output once without blocking, used by the device thread or a custom event loop
+            @param:  _now - const clock::time_point, current time
+        */
+        void service(const clock::time_point _now) noexcept {
+            char buffer[4096];
+            for (ssize_t size; (size = ::read(fd(), buffer, sizeof(buffer))) > 0;) {
+                m_stats.bytes_in.fetch_add(static_cast<uint64_t>(size), std::memory_order_relaxed);
+                m_request.append(buffer, static_cast<std::size_t>(size));
+            }
+            for (std::size_t end; (end = m_request.find(m_delimiter)) != std::string::npos;) {
+                dispatch(std::string_view(m_request).substr(0, end), _now);
+                m_request.erase(0, end + 1);
+            }
+
+            while (!m_pending.empty() && m_pending.begin()->first <= _now) {
+                transmit(std::move(m_pending.begin()->second));
+                m_pending.erase(m_pending.begin());
+                m_stats.responses.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            if (streaming()) {
+                const auto due { static_cast<uint64_t>(std::chrono::duration<double>(_now - m_stream_begin).count() * m_stream_rate) };
+                std::string chunk;
+                for (; m_stream_emitted < due; ++m_stream_emitted) {
+                    if (m_stream_offset == m_stream.size()) {
+                        m_stream_offset = 0;
+                        if (m_stream_generator) { m_stream = m_stream_generator(); }
+                        if (m_stream.empty()) { break; }
+                    }
+                    chunk.push_back(m_stream[m_stream_offset++]);
+                }
+                transmit(std::move(chunk));
+            }
+        }
+
+        /*
+            @brief: Get device counters, safe to call while the device runs
+            @return: sim_stats - counters snapshot
+        */
+        sim_stats stats() const noexcept {
+            return {
+                m_stats.bytes_in.load(std::memory_order_relaxed),
+                m_stats.bytes_out.load(std::memory_order_relaxed),
+                m_stats.bytes_dropped.load(std::memory_order_relaxed),
+                m_stats.bits_flipped.load(std::memory_order_relaxed),
+                m_stats.requests.load(std::memory_order_relaxed),
+                m_stats.responses.load(std::memory_order_relaxed)
+            };
+        }
+
+    private:
+        struct SimRule {
+            std::string               request;
+            std::string               response;
+            std::chrono::microseconds latency;
+
+            SimRule(std::string _request, std::string _response, const std::chrono::microseconds _latency) noexcept
+                : request(std::move(_request)), response(std::move(_response)), latency(_latency) {}
+        };
+
+        struct SimCounters {
+            std::atomic<uint64_t> bytes_in      { 0 };
+            std::atomic<uint64_t> bytes_out     { 0 };
+            std::atomic<uint64_t> bytes_dropped { 0 };
+            std::atomic<uint64_t> bits_flipped  { 0 };
+            std::atomic<uint64_t> requests      { 0 };
+            std::atomic<uint64_t> responses     { 0 };
+        };
+
+        bool streaming() const noexcept { return m_stream_rate > 0 && (!m_stream.empty() || m_stream_generator); }
+
+        void dispatch(const std::string_view _request, const clock::time_point _now) noexcept {
+            m_stats.requests.fetch_add(1, std::memory_order_relaxed);
+            const auto rule { std::ranges::find(m_rules, _request, &SimRule::request) };
+            if (rule != m_rules.end()) {
+                m_pending.emplace(_now + rule->latency, rule->response);
+            } else if (m_handler) {
+                auto response { m_handler(_request) };
+                if (!response.empty()) { m_pending.emplace(_now + m_handler_latency, std::move(response)); }
+            }
+        }
+
+        void transmit(std::string _data) noexcept {
+            if (_data.empty()) { return; }
+            m_stats.bits_flipped.fetch_add(simlib::detail::flipBits(_data, m_bit_error_rate, m_engine), std::memory_order_relaxed);
+
+            std::size_t sent { 0 };
+            while (sent < _data.size()) {
+                const auto written { ::write(fd(), _data.data() + sent, _data.size() - sent) };
+                if (written <= 0) { break; }
+                sent += static_cast<std::size_t>(written);
+            }
+            m_stats.bytes_out.fetch_add(sent, std::memory_order_relaxed);
+            m_stats.bytes_dropped.fetch_add(_data.size() - sent, std::memory_order_relaxed);
+        }
+
+        pty_pair                                      m_pty;
+        const char                                    m_delimiter;
+        std::vector<SimRule>                          m_rules;
+        handler_type                                  m_handler;
+        std::chrono::microseconds                     m_handler_latency { 0 };
+        std::string                                   m_stream;
+        generator_type                                m_stream_generator;
+        std::size_t                                   m_stream_offset   { 0 };
+        double                                        m_stream_rate     { 0 };
+        clock::time_point                             m_stream_begin;
+        uint64_t                                      m_stream_emitted  { 0 };
+        double                                        m_bit_error_rate  { 0 };
+        std::mt19937_64                               m_engine;
+        std::string                                   m_request;
+        std::multimap<clock::time_point, std::string> m_pending;
+        SimCounters                                   m_stats;
+        std::jthread                                  m_thread;
+    };
+
+    struct link_options {
+        std::size_t               baudrate       { 115200 };
+        std::size_t               data_bits      { 8 };
+        std::size_t               parity_bits    { 0 };
+        std::size_t               stop_bits      { 1 };
+        std::chrono::microseconds jitter         { 0 };
+        double                    bit_error_rate { 0 };
+        uint64_t                  seed           { 0 };
+        std::size_t               buffer_size    { 4096 };
+    };
+
+    /*
+        @brief: Line emulating shim between a host pty and a device, bytes are forwarded at the character rate of the configured UART framing
+                Each character takes (start + data + parity + stop bits) / baudrate, delivery is delayed by uniform jitter and bits flip at random
+    */
+    class sim_link {
+    public:
+        using clock = simlib::detail::clock;
+
+        /*
+            @brief: Open the device end in raw mode and a pty for the host end
+            @param:  _device  - std::string_view, device name, e.g. sim_device::name() or a real tty
+            @param:  _options - const link_options &, line parameters, buffer_size bounds bytes in flight per direction
+        */
+        explicit sim_link(const std::string_view _device, const link_options& _options = {}) noexcept : m_options(_options) {
+            const std::string device(_device);
+            m_device = ::open(device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+            if (m_device < 0 || !m_pty.is_open()) { return; }
+
+            struct termios opt;
+            ::tcgetattr(m_device, &opt);
+            ::cfmakeraw(&opt);
+            ::tcsetattr(m_device, TCSANOW, &opt);
+            ::fcntl(m_pty.master(), F_SETFL, ::fcntl(m_pty.master(), F_GETFL) | O_NONBLOCK);
+
+            const std::size_t bits { 1 + _options.data_bits + _options.parity_bits + _options.stop_bits };
+            m_char_time = std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(bits) / static_cast<double>(std::max<std::size_t>(_options.baudrate, 1)))
+            );
+            m_engine.seed(_options.seed);
+            m_read_buffer.reserve(_options.buffer_size);
+            m_due_buffer.reserve(_options.buffer_size);
+        }
+
+        sim_link(const sim_link&)            = delete;
+        sim_link& operator=(const sim_link&) = delete;
+
+        /*
+            @brief: Default destructor of sim_link, stops forwarding and closes the device end
+        */
+        ~sim_link() noexcept {
+            stop();
+            if (m_device >= 0) { ::close(m_device); }
+        }
+
+        /*
+            @brief: Get link status
+            @return: bool - whether both ends are opened
+        */
+        bool is_open() const noexcept { return m_device >= 0 && m_pty.is_open(); }
+
+        /*
+            @brief: Get host end device name, pass to serialib
+            @return: std::string_view - device name, e.g. '/dev/pts/3'
+        */
+        std::string_view name() const noexcept { return m_pty.name(); }
+
+        /*
+            @brief: Start the forwarding thread
+            @return: bool - whether the link is started
+        */
+        bool start() noexcept {
+            if (!is_open() || m_thread.joinable()) { return false; }
+            m_thread = std::jthread([this](std::stop_token _stop) {
+                LinkQueue& to_device { m_queues[link_directions::to_device] };
+                LinkQueue& to_host   { m_queues[link_directions::to_host]   };
+                while (!_stop.stop_requested()) {
+                    // Stop reading a side whose queue is full so the writer sees backpressure like a full UART FIFO
+                    struct pollfd pfds[2] {
+                        { m_pty.master(), static_cast<short>(to_device.bytes.size() < m_options.buffer_size ? POLLIN : 0), 0 },
+                        { m_device,       static_cast<short>(to_host.bytes.size()   < m_options.buffer_size ? POLLIN : 0), 0 }
+                    };
+                    auto wait { std::chrono::nanoseconds(std::chrono::milliseconds(10)) };
+                    for (const auto* queue : { &to_device, &to_host }) {
+                        if (!queue->bytes.empty()) { wait = std::min(wait, std::chrono::nanoseconds(queue->bytes.front().first - clock::now())); }
+                    }
+                    const struct timespec timeout { 0, std::max<long>(wait.count(), 0) };
+                    ::ppoll(pfds, 2, &timeout, nullptr);
+
+                    const auto now { clock::now() };
+                    forward(m_pty.master(), m_device, to_device, now, (pfds[0].revents & POLLIN) != 0);
+                    forward(m_device, m_pty.master(), to_host, now, (pfds[1].revents & POLLIN) != 0);
+                }
+            });
+
+            return true;
+        }
+
+        /*
+            @brief: Stop the forwarding thread, bytes in flight are discarded
+        */
+        void stop() noexcept {
+            if (!m_thread.joinable()) { return; }
+            m_thread.request_stop();
+            m_thread.join();
+        }
+
+        /*
+            @brief: Get counters of one direction, safe to call while the link runs, requests and responses are unused
+            @param:  _direction - const link_directions, to_device or to_host
+            @return: sim_stats  - counters snapshot
+        */
+        sim_stats stats(const link_directions _direction) const noexcept {
+            const LinkQueue& queue { m_queues[_direction] };
+            return {
+                queue.bytes_in.load(std::memory_order_relaxed),
+                queue.bytes_out.load(std::memory_order_relaxed),
+                queue.bytes_dropped.load(std::memory_order_relaxed),
+                queue.bits_flipped.load(std::memory_order_relaxed),
+                0, 0
+            };
+        }
+
+    private:
+        struct LinkQueue {
+            std::deque<std::pair<clock::time_point, char>> bytes;
+            clock::time_point                              tx_end;
+            clock::time_point                              delivery;
+            std::atomic<uint64_t>                          bytes_in      { 0 };
+            std::atomic<uint64_t>                          bytes_out     { 0 };
+            std::atomic<uint64_t>                          bytes_dropped { 0 };
+            std::atomic<uint64_t>                          bits_flipped  { 0 };
+        };
+
+        // Scratch buffers are shared by both directions, only the forwarding thread uses them and keeps their capacity
+        void forward(const int _from, const int _to, LinkQueue& queue_, const clock::time_point _now, const bool _readable) noexcept {
+            if (_readable && queue_.bytes.size() < m_options.buffer_size) {
+                std::string& buffer { m_read_buffer };
+                buffer.resize(m_options.buffer_size - queue_.bytes.size());
+                const auto size { ::read(_from, buffer.data(), buffer.size()) };
+                if (size > 0) {
+                    buffer.resize(static_cast<std::size_t>(size));
+                    queue_.bytes_in.fetch_add(buffer.size(), std::memory_order_relaxed);
+                    queue_.bits_flipped.fetch_add(simlib::detail::flipBits(buffer, m_options.bit_error_rate, m_engine), std::memory_order_relaxed);
+
+                    const auto mask { static_cast<char>((1u << std::min<std::size_t>(m_options.data_bits, 8)) - 1) };
+                    std::uniform_int_distribution<int64_t> jitter(0, std::chrono::duration_cast<std::chrono::nanoseconds>(m_options.jitter).count());
+                    for (const char byte : buffer) {
+                        // Characters serialize back to back, jitter delays delivery but never reorders
+                        queue_.tx_end   = std::max(queue_.tx_end, _now) + m_char_time;
+                        queue_.delivery = std::max(queue_.delivery, queue_.tx_end + std::chrono::nanoseconds(jitter(m_engine)));
+                        queue_.bytes.emplace_back(queue_.delivery, static_cast<char>(byte & mask));
+                    }
+                }
+            }
+
+            std::string& due { m_due_buffer };
+            due.clear();
+            while (!queue_.bytes.empty() && queue_.bytes.front().first <= _now) {
+                due.push_back(queue_.bytes.front().second);
+                queue_.bytes.pop_front();
+            }
+            if (due.empty()) { return; }
+
+            const auto written { std::max<ssize_t>(::write(_to, due.data(), due.size()), 0) };
+            queue_.bytes_out.fetch_add(static_cast<uint64_t>(written), std::memory_order_relaxed);
+            queue_.bytes_dropped.fetch_add(due.size() - static_cast<std::size_t>(written), std::memory_order_relaxed);
+        }
+
+        const link_options m_options;
+        pty_pair           m_pty;
+        int                m_device    { -1 };
+        clock::duration    m_char_time { 0 };
+        std::mt19937_64    m_engine;
+        LinkQueue          m_queues[2];
+        std::string        m_read_buffer;
+        std::string        m_due_buffer;
+        std::jthread       m_thread;
+    };
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "serialib.hpp"
+#include "timelib.hpp"
+
+namespace ubn {
+    namespace synclib::detail {
+        // Request is '#TS <sequence>\n', reply is '#TR <sequence> <t2> <t3>\n', all fields lowercase hex
+        constexpr std::string_view sync_request { "#TS " };
+        constexpr std::string_view sync_reply   { "#TR " };
+
+        inline void appendHex(std::string& text_, const uint64_t _value) noexcept {
+            char       buffer[16];
+            const auto result { std::to_chars(buffer, buffer + sizeof(buffer), _value, 16) };
+            text_.append(buffer, result.ptr);
+        }
+
+        inline bool parseHex(std::string_view& text_, uint64_t& value_) noexcept {
+            const auto result { std::from_chars(text_.data(), text_.data() + text_.size(), value_, 16) };
+            if (result.ec != std::errc() || result.ptr == text_.data()) { return false; }
+            text_.remove_prefix(static_cast<std::size_t>(result.ptr - text_.data()));
+            if (!text_.empty() && text_.front() == ' ') { text_.remove_prefix(1); }
+            return true;
+        }
+    }
+
+    struct sync_sample {
+        uint64_t t1 { 0 };
+        uint64_t t2 { 0 };
+        uint64_t t3 { 0 };
+        uint64_t t4 { 0 };
+
+        /*
+            @brief: Get device minus host clock offset, exact when both directions take the same time
+            @return: int64_t - nanoseconds
+        */
+        int64_t offset() const noexcept {
+            return (static_cast<int64_t>(t2 - t1) + static_cast<int64_t>(t3 - t4)) / 2;
+        }
+
+        /*
+            @brief: Get round trip delay excluding the device processing time
+            @return: int64_t - nanoseconds
+        */
+        int64_t delay() const noexcept {
+            return static_cast<int64_t>(t4 - t1) - static_cast<int64_t>(t3 - t2);
+        }
+    };
+
+    // Defaults take about 1.6 s and give a drift estimate, 32 exchanges 50 ms apart span 1.55 s and the 8 kept samples almost always span 500 ms
+    struct sync_options {
+        std::size_t               count      { 32 };
+        std::chrono::milliseconds interval   { 50 };
+        double                    keep       { 0.25 };
+        std::chrono::milliseconds timeout    { 100 };
+        std::chrono::milliseconds drift_span { 500 };
+    };
+
+    struct sync_result {
+        bool        valid     { false };
+        uint64_t    reference { 0 };
+        double      offset    { 0 };
+        double      drift       { 0 };
+        double      drift_error { 0 };
+        bool        drift_valid { false };
+        int64_t     delay     { 0 };
+        std::size_t samples   { 0 };
+        std::size_t used      { 0 };
+
+        /*
+            @brief: Map a device timestamp to host time, device = host + offset + drift * (host - reference), drift is 0 unless drift_valid
+            @param:  _device  - const uint64_t, device clock in nanoseconds
+            @return: uint64_t - host tsc_ns() time
+        */
+        uint64_t to_host(const uint64_t _device) const noexcept {
+            const double device { static_cast<double>(static_cast<int64_t>(_device - reference)) };
+            return reference + static_cast<uint64_t>(static_cast<int64_t>((device - offset) / (1 + drift)));
+        }
+
+        /*
+            @brief: Operator << for std::ostream
+            @param: _os            - std::ostream &, output stream
+            @param: _rhs           - const sync_result &, sync result
+            @return: std::ostream & - output stream
+        */
+        friend std::ostream& operator<<(std::ostream& _os, const sync_result& _rhs) noexcept {
+            _os << "valid: "       << _rhs.valid
+                << ", offset: "    << _rhs.offset / 1e3 << "us"
+                << ", drift: "     << _rhs.drift * 1e6  << "ppm"
+                << " +/- "         << _rhs.drift_error * 1e6 << "ppm" << (_rhs.drift_valid ? "" : " (ignored)")
+                << ", min delay: " << static_cast<double>(_rhs.delay) / 1e3 << "us"
+                << ", samples: "   << _rhs.used << '/' << _rhs.samples;
+            return _os;
+        }
+    };
+
+    /*
+        @brief: Build the device reply to a time sync request, for device firmware ports or sim_device handlers
+        @param:  _request - const std::string_view, received request line without '\n'
+        @param:  _t2      - const uint64_t, device time when the request arrived, in nanoseconds
+        @param:  _t3      - const uint64_t, device time when the reply is sent, in nanoseconds
+        @return: std::string - reply line with '\n', empty if the request is not a time sync request
+    */
+    inline std::string time_sync_reply(std::string_view _request, const uint64_t _t2, const uint64_t _t3) noexcept {
+        using namespace ubn::synclib::detail;
+        if (!_request.starts_with(sync_request)) { return {}; }
+        _request.remove_prefix(sync_request.size());
+        uint64_t sequence { 0 };
+        if (!parseHex(_request, sequence)) { return {}; }
+
+        std::string reply(sync_reply);
+        appendHex(reply, sequence);
+        reply.push_back(' ');
+        appendHex(reply, _t2);
+        reply.push_back(' ');
+        appendHex(reply, _t3);
+        reply.push_back('\n');
+        return reply;
+    }
+
+    /*
+        @brief: Estimate device clock offset and drift with NTP style exchanges, keeping the minimum delay samples and fitting a line through them
+                t1 is the host time the request's last byte reaches the line end, t4 the estimated first byte arrival of the reply,
+                so line time is removed when the device stamps t2 on request complete and t3 on reply start
+        @param:  _serial  - const serialib &, opened serial port, the device answers with time_sync_reply()
+        @param:  _options - const sync_options &, exchanges, interval between them, fraction of lowest delay samples kept, reply timeout and
+                            minimum time span of kept samples for a drift estimate, the defaults estimate drift
+        @return: sync_result - offset at reference host time, drift ratio with its standard error, minimum delay and sample counts
+                               drift is applied only when kept samples span drift_span and it exceeds twice its standard error,
+                               otherwise jitter dominates it and the offset alone maps better, re-sync periodically to bound the mapping error
+    */
+    inline sync_result time_sync(const serialib& _serial, const sync_options& _options = {}) noexcept {
+        using namespace ubn::synclib::detail;
+
+        sync_result result;
+        if (!_serial.is_open()) { return result; }
+
+        std::vector<sync_sample> samples;
+        std::string              pending;
+        for (uint64_t sequence = 0; sequence != _options.count; ++sequence) {
+            if (sequence != 0) { std::this_thread::sleep_for(_options.interval); }
+
+            std::string request(sync_request);
+            appendHex(request, sequence);
+            request.push_back('\n');
+
+            sync_sample sample;
+            sample.t1 = tsc_ns() + _serial.line_time(request.size());
+            if (!(_serial << request)) { continue; }
+
+            // Stale replies of timed out requests are skipped by sequence
+            bool           matched  { false };
+            const uint64_t deadline { tsc_ns() + static_cast<uint64_t>(std::chrono::nanoseconds(_options.timeout).count()) };
+            while (!matched && tsc_ns() < deadline) {
+                serial_chunk chunk;
+                if (!_serial.read_wait(1) || !_serial.read_timestamped(chunk)) { continue; }
+
+                pending.append(chunk.data);
+                for (std::size_t begin = 0, end; !matched && (end = pending.find('\n', begin)) != std::string::npos; begin = end + 1) {
+                    std::string_view line { std::string_view(pending).substr(begin, end - begin) };
+                    uint64_t         replied { 0 };
+                    if (!line.starts_with(sync_reply)) { continue; }
+                    line.remove_prefix(sync_reply.size());
+                    if (!parseHex(line, replied) || replied != sequence || !parseHex(line, sample.t2) || !parseHex(line, sample.t3)) { continue; }
+
+                    // Reply may span chunks, back off from the last byte read by the line time of everything since its first byte
+                    sample.t4 = chunk.timestamp - _serial.line_time(pending.size() - begin);
+                    matched   = true;
+                }
+                if (matched) {
+                    pending.clear();
+                } else if (const auto last { pending.rfind('\n') }; last != std::string::npos) {
+                    pending.erase(0, last + 1);
+                }
+            }
+            if (matched) { samples.push_back(sample); }
+        }
+
+        result.samples = samples.size();
+        if (samples.empty()) { return result; }
+
+        std::ranges::sort(samples, {}, &sync_sample::delay);
+        const std::size_t used { std::clamp<std::size_t>(static_cast<std::size_t>(static_cast<double>(samples.size()) * _options.keep), 1, samples.size()) };
+        samples.resize(used);
+
+        // Least squares of offset against host time at the midpoint of each exchange
+        result.reference = samples.front().t1 + (samples.front().t4 - samples.front().t1) / 2;
+        double sum_x { 0 }, sum_y { 0 }, sum_xx { 0 }, sum_xy { 0 };
+        for (const auto& sample : samples) {
+            const double x { static_cast<double>(static_cast<int64_t>(sample.t1 + (sample.t4 - sample.t1) / 2 - result.reference)) };
+            const double y { static_cast<double>(sample.offset()) };
+            sum_x  += x;
+            sum_y  += y;
+            sum_xx += x * x;
+            sum_xy += x * y;
+        }
+        const double n           { static_cast<double>(used) };
+        const double denominator { n * sum_xx - sum_x * sum_x };
+        const double drift       { used > 2 && denominator > 0 ? (n * sum_xy - sum_x * sum_y) / denominator : 0 };
+
+        // Slope standard error from the residuals, sqrt(residual variance / sum of squared x deviations)
+        if (drift != 0) {
+            const double intercept { (sum_y - drift * sum_x) / n };
+            double       residuals { 0 };
+            for (const auto& sample : samples) {
+                const double x { static_cast<double>(static_cast<int64_t>(sample.t1 + (sample.t4 - sample.t1) / 2 - result.reference)) };
+                const double r { static_cast<double>(sample.offset()) - intercept - drift * x };
+                residuals += r * r;
+            }
+            result.drift_error = std::sqrt(residuals / (n - 2) / (denominator / n));
+        }
+        const auto [min_x, max_x] { std::ranges::minmax(samples, {}, [](const sync_sample& _sample) { return _sample.t1 + (_sample.t4 - _sample.t1) / 2; }) };
+        const uint64_t span { (max_x.t1 + (max_x.t4 - max_x.t1) / 2) - (min_x.t1 + (min_x.t4 - min_x.t1) / 2) };
+        result.drift_valid = drift != 0 && span >= static_cast<uint64_t>(std::chrono::nanoseconds(_options.drift_span).count()) &&
+                             std::abs(drift) > 2 * result.drift_error;
+        result.drift  = result.drift_valid ? drift : 0;
+        result.offset = (sum_y - result.drift * sum_x) / n;
+        result.delay  = samples.front().delay();
+        result.used   = used;
+        result.valid  = true;
+
+        return result;
+    }
+}
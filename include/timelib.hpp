@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+    #include <time.h>
+}
+
+namespace ubn {
+    namespace timelib::detail {
+        inline uint64_t readMonotonicRaw() noexcept {
+            struct timespec ts {};
+            ::clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+        }
+
+        // TSC to CLOCK_MONOTONIC_RAW mapping, ns = ns0 + ((tsc - tsc0) * mult) >> 32
+        struct TSCCalibration {
+            bool     available { false };
+            uint64_t tsc0      { 0 };
+            uint64_t ns0       { 0 };
+            uint64_t mult      { 0 };
+        };
+
+        inline uint64_t readTSC() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return 0;
+#endif
+        }
+
+        inline bool hasInvariantTSC() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            unsigned int eax { 0 }, ebx { 0 }, ecx { 0 }, edx { 0 };
+            return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8)) != 0;
+#else
+            return false;
+#endif
+        }
+
+        // Pair a TSC reading with the clock reading that brackets it most tightly
+        inline void sampleTSC(uint64_t& tsc_, uint64_t& ns_) noexcept {
+            uint64_t best { UINT64_MAX };
+            for (int i = 0; i != 16; ++i) {
+                const uint64_t before { readMonotonicRaw() };
+                const uint64_t tsc    { readTSC() };
+                const uint64_t after  { readMonotonicRaw() };
+                if (after - before < best) {
+                    best = after - before;
+                    tsc_ = tsc;
+                    ns_  = before + (after - before) / 2;
+                }
+            }
+        }
+
+        // The fixed point mapping needs 128 bits integers, targets without them use the clock directly
+        inline TSCCalibration calibrateTSC() noexcept {
+            TSCCalibration calibration;
+#if defined(__SIZEOF_INT128__)
+            if (!hasInvariantTSC()) { return calibration; }
+
+            uint64_t tsc_begin { 0 }, ns_begin { 0 };
+            sampleTSC(tsc_begin, ns_begin);
+            const struct timespec window { 0, 5000000 };
+            ::nanosleep(&window, nullptr);
+            sampleTSC(calibration.tsc0, calibration.ns0);
+            if (calibration.tsc0 <= tsc_begin) { return calibration; }
+
+            calibration.mult      = static_cast<uint64_t>(
+                (static_cast<unsigned __int128>(calibration.ns0 - ns_begin) << 32) / (calibration.tsc0 - tsc_begin)
+            );
+            calibration.available = calibration.mult != 0;
+#endif
+            return calibration;
+        }
+
+        inline const TSCCalibration& tscCalibration() noexcept {
+            static const TSCCalibration calibration { calibrateTSC() };
+            return calibration;
+        }
+    }
+
+    /*
+        @brief: Get monotonic time not slewed by NTP, used for all serialib latency measurements
+        @return: uint64_t - CLOCK_MONOTONIC_RAW in nanoseconds, not comparable with std::chrono::steady_clock
+    */
+    inline uint64_t monotonic_ns() noexcept { return timelib::detail::readMonotonicRaw(); }
+
+    /*
+        @brief: Calibrate the TSC against CLOCK_MONOTONIC_RAW over 5 ms, runs once, serialib calls it on open so reads never pay for it
+        @return: bool - whether an invariant TSC is available on a target with 128 bits integers, tsc_ns() falls back to monotonic_ns() otherwise
+    */
+    inline bool tsc_calibrate() noexcept { return timelib::detail::tscCalibration().available; }
+
+    /*
+        @brief: Get CLOCK_MONOTONIC_RAW time from the TSC without a syscall or vDSO call, calibrated on first use
+        @return: uint64_t - nanoseconds on the monotonic_ns() timeline, drifting from it by the calibration error of about 10 ppm
+    */
+    inline uint64_t tsc_ns() noexcept {
+#if defined(__SIZEOF_INT128__)
+        const auto& calibration { timelib::detail::tscCalibration() };
+        if (!calibration.available) { return timelib::detail::readMonotonicRaw(); }
+
+        const uint64_t tsc { timelib::detail::readTSC() };
+        const int64_t  ticks { static_cast<int64_t>(tsc - calibration.tsc0) };
+        const __int128 delta { (static_cast<__int128>(ticks) * static_cast<__int128>(calibration.mult)) >> 32 };
+        return calibration.ns0 + static_cast<uint64_t>(static_cast<int64_t>(delta));
+#else
+        return timelib::detail::readMonotonicRaw();
+#endif
+    }
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "timelib.hpp"
+
+extern "C" {
+    #include <unistd.h>
+    #include <sys/syscall.h>
+}
+
+// Tracing spans are compiled in only with SERIALIB_TRACE=1, otherwise SERIALIB_TRACE_SPAN expands to nothing
+#ifndef SERIALIB_TRACE
+    #define SERIALIB_TRACE 0
+#endif
+
+#define SERIALIB_TRACE_CONCAT_(a, b) a##b
+#define SERIALIB_TRACE_CONCAT(a, b)  SERIALIB_TRACE_CONCAT_(a, b)
+
+#if SERIALIB_TRACE
+    #define SERIALIB_TRACE_SPAN(name) const ::ubn::trace_span SERIALIB_TRACE_CONCAT(serialib_trace_span_, __LINE__) { name }
+#else
+    #define SERIALIB_TRACE_SPAN(name) ((void)0)
+#endif
+
+namespace ubn {
+    namespace tracelib::detail {
+        struct TraceEvent {
+            const char* name  { nullptr };
+            uint64_t    begin { 0 };
+            uint64_t    end   { 0 };
+        };
+
+        enum TraceStates {
+            active, retired, free
+        };
+
+        // Single producer ring, the newest events overwrite the oldest, state and retire order are guarded by the registry lock
+        struct TraceBuffer {
+            std::vector<TraceEvent> events;
+            std::atomic<uint64_t>   size    { 0 };
+            long                    tid     { 0 };
+            TraceStates             state   { active };
+            uint64_t                retired { 0 };
+        };
+
+        struct TraceRegistry {
+            std::vector<std::unique_ptr<TraceBuffer>> buffers;
+            std::atomic<bool>                         enabled     { false };
+            std::atomic<uint64_t>                     dropped     { 0 };
+            std::size_t                               capacity    { 1 << 13 };
+            std::size_t                               max_buffers { 64 };
+            uint64_t                                  retirements { 0 };
+            std::mutex                                lock;
+        };
+
+        inline TraceRegistry& traceRegistry() noexcept {
+            static TraceRegistry registry;
+            return registry;
+        }
+
+        // Reuse a buffer freed by dump or clear, else allocate one below the cap, else take over the longest retired one
+        inline TraceBuffer* acquireTraceBuffer() noexcept {
+            auto& registry { traceRegistry() };
+            const std::lock_guard<std::mutex> registry_gd(registry.lock);
+
+            TraceBuffer* buffer { nullptr };
+            for (auto& candidate : registry.buffers) {
+                if (candidate->state == free) { buffer = candidate.get(); break; }
+            }
+            if (buffer == nullptr && registry.buffers.size() < registry.max_buffers) {
+                buffer = registry.buffers.emplace_back(std::make_unique<TraceBuffer>()).get();
+            }
+            if (buffer == nullptr) {
+                for (auto& candidate : registry.buffers) {
+                    if (candidate->state == retired && (buffer == nullptr || candidate->retired < buffer->retired)) { buffer = candidate.get(); }
+                }
+            }
+            if (buffer == nullptr) { return nullptr; }
+
+            buffer->events.assign(registry.capacity, TraceEvent {});
+            buffer->size.store(0, std::memory_order_relaxed);
+            buffer->tid   = ::syscall(SYS_gettid);
+            buffer->state = active;
+            return buffer;
+        }
+
+        // Retires the buffer on thread exit, its events stay until dumped or cleared, then it is reused by new threads
+        struct TraceSlot {
+            TraceBuffer* buffer { acquireTraceBuffer() };
+
+            ~TraceSlot() noexcept {
+                if (buffer == nullptr) { return; }
+                auto& registry { traceRegistry() };
+                const std::lock_guard<std::mutex> registry_gd(registry.lock);
+                buffer->state   = retired;
+                buffer->retired = ++registry.retirements;
+            }
+        };
+
+        inline TraceBuffer* threadTraceBuffer() noexcept {
+            thread_local TraceSlot slot;
+            return slot.buffer;
+        }
+    }
+
+    /*
+        @brief: Enable or disable recording of compiled in tracing spans at runtime, disabled by default
+        @param:  _enabled - const bool, whether spans are recorded
+    */
+    inline void trace_enable(const bool _enabled) noexcept {
+        tracelib::detail::traceRegistry().enabled.store(_enabled, std::memory_order_relaxed);
+    }
+
+    /*
+        @brief: Size per-thread ring buffers, applies to buffers acquired afterwards, 8192 events (192 KB) and 64 buffers by default
+                Buffers of exited threads are reused once dumped or cleared, when all are in use spans of new threads are dropped
+        @param:  _events  - const std::size_t, events kept per thread, the oldest are overwritten
+        @param:  _buffers - const std::size_t, maximum buffers allocated, bounding memory to _events * _buffers * 24 bytes
+    */
+    inline void trace_configure(const std::size_t _events, const std::size_t _buffers) noexcept {
+        auto& registry { tracelib::detail::traceRegistry() };
+        const std::lock_guard<std::mutex> registry_gd(registry.lock);
+        registry.capacity    = std::max<std::size_t>(_events, 1);
+        registry.max_buffers = std::max<std::size_t>(_buffers, 1);
+    }
+
+    /*
+        @brief: Get spans dropped because their thread found no buffer
+        @return: uint64_t - dropped spans
+    */
+    inline uint64_t trace_dropped() noexcept {
+        return tracelib::detail::traceRegistry().dropped.load(std::memory_order_relaxed);
+    }
+
+    /*
+        @brief: RAII tracing span recorded into the per-thread ring buffer as a complete event, use SERIALIB_TRACE_SPAN in library code
+    */
+    class trace_span {
+    public:
+        /*
+            @brief: Begin a span if tracing is enabled
+            @param:  _name - const char *, span name, must outlive the dump, e.g. a string literal
+        */
+        explicit trace_span(const char* _name) noexcept
+            : m_name(tracelib::detail::traceRegistry().enabled.load(std::memory_order_relaxed) ? _name : nullptr),
+              m_begin(m_name != nullptr ? monotonic_ns() : 0) {}
+
+        trace_span(const trace_span&)            = delete;
+        trace_span& operator=(const trace_span&) = delete;
+
+        /*
+            @brief: End the span and record it
+        */
+        ~trace_span() noexcept {
+            if (m_name == nullptr) { return; }
+            auto* buffer { tracelib::detail::threadTraceBuffer() };
+            if (buffer == nullptr) {
+                tracelib::detail::traceRegistry().dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            const uint64_t index { buffer->size.load(std::memory_order_relaxed) };
+            buffer->events[index % buffer->events.size()] = { m_name, m_begin, monotonic_ns() };
+            buffer->size.store(index + 1, std::memory_order_release);
+        }
+
+    private:
+        const char* m_name;
+        uint64_t    m_begin;
+    };
+
+    /*
+        @brief: Write recorded spans of all threads in Chrome trace event JSON, load in chrome://tracing or ui.perfetto.dev
+                Dump after the traced work is quiet, events overwritten while dumping may appear torn
+                Buffers of exited threads are freed for reuse once dumped
+        @param:  _os            - std::ostream &, output stream, e.g. std::ofstream("trace.json")
+        @return: std::ostream & - output stream
+    */
+    inline std::ostream& trace_dump(std::ostream& _os) noexcept {
+        auto& registry { tracelib::detail::traceRegistry() };
+        const std::lock_guard<std::mutex> registry_gd(registry.lock);
+
+        const auto flags     { _os.flags() };
+        const auto precision { _os.precision() };
+        _os << std::fixed;
+        _os.precision(3);
+        _os << "{\"traceEvents\":[";
+        bool       first { true };
+        const long pid   { static_cast<long>(::getpid()) };
+        for (const auto& buffer : registry.buffers) {
+            const uint64_t size  { buffer->size.load(std::memory_order_acquire) };
+            const uint64_t begin { size > buffer->events.size() ? size - buffer->events.size() : 0 };
+            for (uint64_t i = begin; i != size; ++i) {
+                const auto& event { buffer->events[i % buffer->events.size()] };
+                if (event.name == nullptr) { continue; }
+                _os << (first ? "\n" : ",\n")
+                    << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+                    << ",\"ts\":" << static_cast<double>(event.begin) / 1e3 << ",\"dur\":" << static_cast<double>(event.end - event.begin) / 1e3 << '}';
+                first = false;
+            }
+            if (buffer->state == tracelib::detail::retired) {
+                buffer->size.store(0, std::memory_order_relaxed);
+                buffer->state = tracelib::detail::free;
+            }
+        }
+        _os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        _os.flags(flags);
+        _os.precision(precision);
+
+        return _os;
+    }
+
+    /*
+        @brief: Drop all recorded spans and free buffers of exited threads for reuse, call while the traced work is quiet
+    */
+    inline void trace_clear() noexcept {
+        auto& registry { tracelib::detail::traceRegistry() };
+        const std::lock_guard<std::mutex> registry_gd(registry.lock);
+        for (auto& buffer : registry.buffers) {
+            buffer->size.store(0, std::memory_order_release);
+            if (buffer->state == tracelib::detail::retired) { buffer->state = tracelib::detail::free; }
+        }
+    }
+}